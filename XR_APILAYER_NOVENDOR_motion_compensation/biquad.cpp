@@ -0,0 +1,116 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#include "pch.h"
+
+#include "biquad.h"
+#include "simd.h"
+
+namespace filter
+{
+    BiQuadBank::Coefficients BiQuadBank::Design(const float frequency, const double samplingFrequency)
+    {
+        // keep cutoff below nyquist frequency for long sampling intervals
+        const double normalized = std::min(frequency / samplingFrequency, 0.45);
+        const double r = sin(M_PI_4);
+        const double a = tan(M_PI * normalized);
+        const double aSquare = a * a;
+        const double s = (aSquare + 2.0 * a * r + 1.0);
+        return {aSquare / s, 2.0 * (1.0 - aSquare) / s, -(aSquare - 2.0 * a * r + 1.0) / s};
+    }
+
+    void BiQuadBank::SetFrequency(const size_t channel, const float frequency, const double samplingFrequency)
+    {
+        m_W1[channel] = m_W2[channel] = 0.0;
+        const Coefficients coefficients = frequency <= 0.f ? Coefficients{} // unused channel
+                                                           : Design(frequency, samplingFrequency);
+        m_A[channel] = coefficients.a;
+        m_D1[channel] = coefficients.d1;
+        m_D2[channel] = coefficients.d2;
+    }
+
+    void BiQuadBank::SetCoefficients(const size_t channel, const Coefficients& coefficients)
+    {
+        // rescale delay line to keep output continuous: steady state w = x / (1 - d1 - d2) = x / (4 * a)
+        const double scale = coefficients.a > 0.0 ? m_A[channel] / coefficients.a : 1.0;
+        m_W1[channel] *= scale;
+        m_W2[channel] *= scale;
+        m_A[channel] = coefficients.a;
+        m_D1[channel] = coefficients.d1;
+        m_D2[channel] = coefficients.d2;
+    }
+
+    void BiQuadBank::Prime(const double (&values)[m_Channels])
+    {
+        // set delay line to steady state for constant input x: w = d1 * w + d2 * w + x
+        for (size_t i = 0; i < m_Channels; i++)
+        {
+            const double denominator = 1.0 - m_D1[i] - m_D2[i];
+            m_W1[i] = m_W2[i] = denominator != 0.0 ? values[i] / denominator : 0.0;
+        }
+    }
+
+    void BiQuadBank::Shift(const size_t channel, const double offset)
+    {
+        // subtract offset from input and output: delay line moves by offset / (1 - d1 - d2)
+        const double denominator = 1.0 - m_D1[channel] - m_D2[channel];
+        if (denominator != 0.0)
+        {
+            m_W1[channel] -= offset / denominator;
+            m_W2[channel] -= offset / denominator;
+        }
+    }
+
+    void BiQuadBank::Filter(double (&values)[m_Channels])
+    {
+        // w0 = d1 * w1 + d2 * w2 + x, y = a * (w2 + 2 * w1 + w0)
+        // operation order matches scalar implementation to keep results identical
+#if defined(FILTER_AVX)
+        const __m256d two = _mm256_set1_pd(2.0);
+        for (size_t i = 0; i < m_Channels; i += 4)
+        {
+            const __m256d w1 = _mm256_load_pd(m_W1 + i);
+            const __m256d w2 = _mm256_load_pd(m_W2 + i);
+            const __m256d w0 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_load_pd(m_D1 + i), w1),
+                                                           _mm256_mul_pd(_mm256_load_pd(m_D2 + i), w2)),
+                                             _mm256_loadu_pd(values + i));
+            const __m256d sum = _mm256_add_pd(_mm256_add_pd(w2, _mm256_mul_pd(two, w1)), w0);
+            _mm256_storeu_pd(values + i, _mm256_mul_pd(_mm256_load_pd(m_A + i), sum));
+            _mm256_store_pd(m_W2 + i, w1);
+            _mm256_store_pd(m_W1 + i, w0);
+        }
+#elif defined(FILTER_SSE2)
+        const __m128d two = _mm_set1_pd(2.0);
+        for (size_t i = 0; i < m_Channels; i += 2)
+        {
+            const __m128d w1 = _mm_load_pd(m_W1 + i);
+            const __m128d w2 = _mm_load_pd(m_W2 + i);
+            const __m128d w0 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(_mm_load_pd(m_D1 + i), w1),
+                                                     _mm_mul_pd(_mm_load_pd(m_D2 + i), w2)),
+                                          _mm_loadu_pd(values + i));
+            const __m128d sum = _mm_add_pd(_mm_add_pd(w2, _mm_mul_pd(two, w1)), w0);
+            _mm_storeu_pd(values + i, _mm_mul_pd(_mm_load_pd(m_A + i), sum));
+            _mm_store_pd(m_W2 + i, w1);
+            _mm_store_pd(m_W1 + i, w0);
+        }
+#else
+        for (size_t i = 0; i < m_Channels; i++)
+        {
+            const double w0 = m_D1[i] * m_W1[i] + m_D2[i] * m_W2[i] + values[i];
+            values[i] = m_A[i] * (m_W2[i] + 2.0 * m_W1[i] + w0);
+            m_W2[i] = m_W1[i];
+            m_W1[i] = w0;
+        }
+#endif
+    }
+
+    void IntervalAverage::Reset(const double interval)
+    {
+        m_Average = interval;
+    }
+
+    double IntervalAverage::Update(const int64_t interval)
+    {
+        m_Average += (static_cast<double>(interval) - m_Average) * m_Weight;
+        return m_Average;
+    }
+} // namespace filter
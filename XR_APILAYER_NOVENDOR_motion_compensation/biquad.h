@@ -0,0 +1,52 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#pragma once
+
+namespace filter
+{
+    // structure of arrays holding all biquad (2nd order butterworth low pass) filters of the input stabilizer,
+    // advanced in one (vectorized) pass per sample
+    class BiQuadBank
+    {
+      public:
+        // translation and rotation vector, padded to a multiple of the vector width
+        static constexpr size_t m_Channels{8};
+
+        struct Coefficients
+        {
+            double a, d1, d2;
+        };
+
+        static Coefficients Design(float frequency, double samplingFrequency);
+        // frequency <= 0 deactivates the channel (output is zero)
+        void SetFrequency(size_t channel, float frequency, double samplingFrequency);
+        // replace coefficients without discontinuity of the output
+        void SetCoefficients(size_t channel, const Coefficients& coefficients);
+        // steady state for constant input instead of attack time
+        void Prime(const double (&values)[m_Channels]);
+        // move input and output of a channel by -offset
+        void Shift(size_t channel, double offset);
+        void Filter(double (&values)[m_Channels]);
+
+      private:
+        alignas(32) double m_A[m_Channels]{};
+        alignas(32) double m_D1[m_Channels]{};
+        alignas(32) double m_D2[m_Channels]{};
+        alignas(32) double m_W1[m_Channels]{};
+        alignas(32) double m_W2[m_Channels]{};
+    };
+
+    // mean interval between samples for coefficient adaptation: follows changes of the sampling rate, but not the
+    // jitter of individual intervals, which would raise the gain at the cutoff frequency
+    class IntervalAverage
+    {
+      public:
+        void Reset(double interval);
+        double Update(int64_t interval);
+
+      private:
+        // exponential average over roughly 32 samples
+        static constexpr double m_Weight{1.0 / 32.0};
+        double m_Average{0.0};
+    };
+} // namespace filter
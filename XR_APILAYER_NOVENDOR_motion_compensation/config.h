@@ -17,6 +17,7 @@ enum class Cfg
     TrackerRole,
     TrackerTimeout,
     TrackerCheck,
+    TrackerStaleTimeout,
     TrackerOffsetForward,
     TrackerOffsetDown,
     TrackerOffsetRight,
@@ -40,8 +41,12 @@ enum class Cfg
     TransStrength,
     TransOrder,
     TransVerticalFactor,
+    TransType,
+    TransBeta,
     RotStrength,
     RotOrder,
+    RotType,
+    RotBeta,
     StabilizerEnabled,
     StabilizerStrength,
     StabilizerRoll,
@@ -50,6 +55,17 @@ enum class Cfg
     StabilizerSurge,
     StabilizerSway,
     StabilizerHeave,
+    StabilizerAdaptiveRate,
+    StabilizerOversampling,
+    StabilizerScheduler,
+    StabilizerSpinTime,
+    StabilizerFrameSync,
+    PredictionEnabled,
+    PredictionMaxHorizon,
+    SamplingPriority,
+    SamplingAffinity,
+    BackgroundPriority,
+    BackgroundAffinity,
     FactorEnabled,
     FactorTrackerRoll,
     FactorTrackerPitch,
@@ -65,6 +81,7 @@ enum class Cfg
     FactorHmdHeave,
     CacheUseEye,
     CacheTolerance,
+    CacheInterpolate,
     KeyActivate,
     KeyCalibrate,
     KeyTransInc,
@@ -99,6 +116,7 @@ enum class Cfg
     KeyRecorder,
     TestRotation,
     RecordSamples,
+    StabilizerResponse,
     LogVerbose
 };
 
@@ -146,6 +164,7 @@ class ConfigManager
 
         {Cfg::TrackerTimeout, {"tracker", "connection_timeout"}},
         {Cfg::TrackerCheck, {"tracker", "connection_check"}},
+        {Cfg::TrackerStaleTimeout, {"tracker", "stale_timeout"}},
 
         {Cfg::TrackerOffsetForward, {"tracker", "offset_forward"}},
         {Cfg::TrackerOffsetDown, {"tracker", "offset_down"}},
@@ -177,8 +196,12 @@ class ConfigManager
         {Cfg::TransStrength, {"translation_filter", "strength"}},
         {Cfg::TransOrder, {"translation_filter", "order"}},
         {Cfg::TransVerticalFactor, {"translation_filter", "vertical_factor"}},
+        {Cfg::TransType, {"translation_filter", "type"}},
+        {Cfg::TransBeta, {"translation_filter", "beta"}},
         {Cfg::RotStrength, {"rotation_filter", "strength"}},
         {Cfg::RotOrder, {"rotation_filter", "order"}},
+        {Cfg::RotType, {"rotation_filter", "type"}},
+        {Cfg::RotBeta, {"rotation_filter", "beta"}},
 
         {Cfg::StabilizerEnabled, {"input_stabilizer", "enabled"}},
         {Cfg::StabilizerStrength, {"input_stabilizer", "strength"}},
@@ -188,6 +211,19 @@ class ConfigManager
         {Cfg::StabilizerSurge, {"input_stabilizer", "surge"}},
         {Cfg::StabilizerSway, {"input_stabilizer", "sway"}},
         {Cfg::StabilizerHeave, {"input_stabilizer", "heave"}},
+        {Cfg::StabilizerAdaptiveRate, {"input_stabilizer", "adaptive_rate"}},
+        {Cfg::StabilizerOversampling, {"input_stabilizer", "oversampling"}},
+        {Cfg::StabilizerScheduler, {"input_stabilizer", "scheduler"}},
+        {Cfg::StabilizerSpinTime, {"input_stabilizer", "spin_time"}},
+        {Cfg::StabilizerFrameSync, {"input_stabilizer", "frame_sync"}},
+
+        {Cfg::PredictionEnabled, {"prediction", "enabled"}},
+        {Cfg::PredictionMaxHorizon, {"prediction", "max_horizon"}},
+
+        {Cfg::SamplingPriority, {"threads", "sampling_priority"}},
+        {Cfg::SamplingAffinity, {"threads", "sampling_affinity"}},
+        {Cfg::BackgroundPriority, {"threads", "background_priority"}},
+        {Cfg::BackgroundAffinity, {"threads", "background_affinity"}},
 
         {Cfg::FactorEnabled, {"pose_modifier", "enabled"}},
         {Cfg::FactorTrackerRoll, {"pose_modifier", "tracker_roll"}},
@@ -205,6 +241,7 @@ class ConfigManager
 
         {Cfg::CacheUseEye, {"cache", "use_eye_cache"}},
         {Cfg::CacheTolerance, {"cache", "tolerance"}},
+        {Cfg::CacheInterpolate, {"cache", "interpolate"}},
 
         {Cfg::KeyActivate, {"shortcuts", "activate"}},
         {Cfg::KeyCalibrate, {"shortcuts", "calibrate"}},
@@ -252,6 +289,7 @@ class ConfigManager
 
         {Cfg::LogVerbose, {"debug", "log_verbose"}},
         {Cfg::RecordSamples, {"debug", "record_stabilizer_samples"}},
+        {Cfg::StabilizerResponse, {"debug", "stabilizer_response"}},
         {Cfg::TestRotation, {"debug", "testrotation"}}};
 
     std::set<Cfg> m_KeysToSave{Cfg::TransStrength,
@@ -5,6 +5,8 @@
 #include "filter.h"
 
 #include "config.h"
+#include "layer.h"
+#include "simd.h"
 #include <util.h>
 
 using namespace openxr_api_layer::log;
@@ -13,200 +15,211 @@ using namespace utility;
 
 namespace filter
 {
-    SingleEmaFilter::SingleEmaFilter(const float strength) : FilterBase(strength, "translational")
+    template <int Order>
+    EmaFilter<Order>::EmaFilter(const float strength)
+        : FilterBase<XrVector3f, EmaFilter>(strength, "translational")
     {
         TraceLocalActivity(local);
-        TraceLoggingWriteStart(local, "SingleEmaFilter::SingleEmaFilter", TLArg(strength, "Strength"));
+        TraceLoggingWriteStart(local, "EmaFilter::EmaFilter", TLArg(Order, "Order"), TLArg(strength, "Strength"));
 
         GetConfig()->GetFloat(Cfg::TransVerticalFactor, m_VerticalFactor);
         m_VerticalFactor = std::max(0.0f, m_VerticalFactor);
-        openxr_api_layer::log::DebugLog("%s filter vertical factor set: %f", m_Type.c_str(), m_VerticalFactor);
-        SingleEmaFilter::SetStrength(m_Strength);
+        openxr_api_layer::log::DebugLog("%s filter vertical factor set: %f", this->m_Type.c_str(), m_VerticalFactor);
+        SetStrength(this->m_Strength);
 
-        TraceLoggingWriteStop(local, "SingleEmaFilter::SingleEmaFilter", TLArg(m_VerticalFactor, "VerticalFactor"));
+        TraceLoggingWriteStop(local, "EmaFilter::EmaFilter", TLArg(m_VerticalFactor, "VerticalFactor"));
     }
 
-    XrVector3f SingleEmaFilter::EmaFunction(const XrVector3f current, const XrVector3f stored) const
-    {
-        return m_Alpha * current + m_OneMinusAlpha * stored;
-    }
-
-    float SingleEmaFilter::SetStrength(const float strength)
+    template <int Order>
+    float EmaFilter<Order>::SetStrength(const float strength)
     {
         TraceLocalActivity(local);
-        TraceLoggingWriteStart(local, "SingleEmaFilter::SetStrength", TLArg(strength, "Strength"));
+        TraceLoggingWriteStart(local, "EmaFilter::SetStrength", TLArg(strength, "Strength"));
 
-        FilterBase::SetStrength(strength);
-        m_Alpha = {1.0f - m_Strength, std::max(0.f, 1.0f - (m_VerticalFactor * m_Strength)), 1.0f - m_Strength};
+        FilterBase<XrVector3f, EmaFilter>::SetStrength(strength);
+        const float value = this->m_Strength;
+        m_Alpha = {1.0f - value, std::max(0.f, 1.0f - (m_VerticalFactor * value)), 1.0f - value};
         m_OneMinusAlpha = {1.f - m_Alpha.x, 1.f - m_Alpha.y, 1.f - m_Alpha.z};
 
         TraceLoggingWriteStop(local,
-                              "SingleEmaFilter::SetStrength",
+                              "EmaFilter::SetStrength",
                               TLArg(xr::ToString(m_Alpha).c_str(), "Alpha"),
                               TLArg(xr::ToString(m_OneMinusAlpha).c_str(), "OneMinusAlpha"));
 
-        return m_Strength;
+        return this->m_Strength;
     }
 
-    void SingleEmaFilter::ApplyFilter(XrVector3f& location)
+    template class EmaFilter<1>;
+    template class EmaFilter<2>;
+    template class EmaFilter<3>;
+
+    namespace
+    {
+        // maximum cutoff frequency of one euro filter (used for minimal filter strength)
+        constexpr float oneEuroMaxCutoff{25.f};
+        constexpr float oneEuroDerivativeCutoff{1.f};
+
+        float OneEuroAlpha(const float cutoff, const double duration)
+        {
+            const double tau = 1.0 / (2.0 * M_PI * cutoff);
+            return static_cast<float>(1.0 / (1.0 + tau / duration));
+        }
+    } // namespace
+
+    OneEuroTranslationFilter::OneEuroTranslationFilter(const float strength) : FilterBase(strength, "translational")
     {
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local,
-                               "SingleEmaFilter::ApplyFilter",
-                               TLArg(xr::ToString(location).c_str(), "location"),
-                               TLArg(xr::ToString(this->m_Ema).c_str(), "m_Ema"),
-                               TLArg(xr::ToString(this->m_Alpha).c_str(), "m_Alpha"));
+                               "OneEuroTranslationFilter::OneEuroTranslationFilter",
+                               TLArg(strength, "Strength"));
 
-        m_Ema = EmaFunction(location, m_Ema);
-        location = m_Ema;
+        GetConfig()->GetFloat(Cfg::TransVerticalFactor, m_VerticalFactor);
+        m_VerticalFactor = std::max(0.0f, m_VerticalFactor);
+        GetConfig()->GetFloat(Cfg::TransBeta, m_Beta);
+        m_Beta = std::max(0.0f, m_Beta);
+        DebugLog("%s one euro filter beta set: %f", m_Type.c_str(), m_Beta);
+        OneEuroTranslationFilter::SetStrength(m_Strength);
 
         TraceLoggingWriteStop(local,
-                              "SingleEmaFilter::ApplyFilter",
-                              TLArg(xr::ToString(location).c_str(), "location"),
-                              TLArg(xr::ToString(this->m_Ema).c_str(), "m_Ema"));
-    }
-
-    void SingleEmaFilter::Reset(const XrVector3f& location)
-    {
-        m_Ema = location;
+                              "OneEuroTranslationFilter::OneEuroTranslationFilter",
+                              TLArg(m_VerticalFactor, "VerticalFactor"),
+                              TLArg(m_Beta, "Beta"));
     }
 
-    void DoubleEmaFilter::ApplyFilter(XrVector3f& location)
+    float OneEuroTranslationFilter::SetStrength(const float strength)
     {
         TraceLocalActivity(local);
-        TraceLoggingWriteStart(local,
-                               "DoubleEmaFilter::ApplyFilter",
-                               TLArg(xr::ToString(location).c_str(), "location"),
-                               TLArg(xr::ToString(this->m_Ema).c_str(), "m_Ema"),
-                               TLArg(xr::ToString(this->m_EmaEma).c_str(), "m_EmaEma"),
-                               TLArg(xr::ToString(this->m_Alpha).c_str(), "m_Alpha"));
+        TraceLoggingWriteStart(local, "OneEuroTranslationFilter::SetStrength", TLArg(strength, "Strength"));
 
-        m_Ema = EmaFunction(location, m_Ema);
-        m_EmaEma = EmaFunction(m_Ema, m_EmaEma);
-        location = XrVector3f{2, 2, 2} * m_Ema - m_EmaEma;
+        FilterBase::SetStrength(strength);
+        const float vertical = std::min(1.f, m_VerticalFactor * m_Strength);
+        m_MinCutoff = {oneEuroMaxCutoff * (1.f - m_Strength),
+                       oneEuroMaxCutoff * (1.f - vertical),
+                       oneEuroMaxCutoff * (1.f - m_Strength)};
 
         TraceLoggingWriteStop(local,
-                              "DoubleEmaFilter::ApplyFilter",
-                              TLArg(xr::ToString(location).c_str(), "location"),
-                              TLArg(xr::ToString(this->m_Ema).c_str(), "m_Ema"),
-                              TLArg(xr::ToString(this->m_EmaEma).c_str(), "m_EmaEma"));
-    }
-
-    void DoubleEmaFilter::Reset(const XrVector3f& location)
-    {
-        SingleEmaFilter::Reset(location);
-        m_EmaEma = location;
+                              "OneEuroTranslationFilter::SetStrength",
+                              TLArg(xr::ToString(m_MinCutoff).c_str(), "MinCutoff"));
+        return m_Strength;
     }
 
-    void TripleEmaFilter::ApplyFilter(XrVector3f& location)
+    void OneEuroTranslationFilter::ApplyFilter(XrVector3f& location, const XrTime time)
     {
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local,
-                               "TripleEmaFilter::ApplyFilter",
+                               "OneEuroTranslationFilter::ApplyFilter",
                                TLArg(xr::ToString(location).c_str(), "location"),
-                               TLArg(xr::ToString(this->m_Ema).c_str(), "m_Ema"),
-                               TLArg(xr::ToString(this->m_EmaEma).c_str(), "m_EmaEma"),
-                               TLArg(xr::ToString(this->m_EmaEmaEma).c_str(), "m_EmaEmaEma"),
-                               TLArg(xr::ToString(this->m_Alpha).c_str(), "m_Alpha"));
+                               TLArg(xr::ToString(this->m_Previous).c_str(), "m_Previous"),
+                               TLArg(time, "Time"));
+
+        if (!m_LastTime)
+        {
+            m_LastTime = time;
+            m_PreviousInput = location;
+        }
+        const double duration = (time - m_LastTime) / 1e9;
+        if (duration <= 0.0)
+        {
+            // no time elapsed (or earlier time requested)
+            location = m_Previous;
+            TraceLoggingWriteStop(local, "OneEuroTranslationFilter::ApplyFilter", TLArg(duration, "Duration"));
+            return;
+        }
+        m_LastTime = time;
+
+        const XrVector3f step = location - m_PreviousInput;
+        m_PreviousInput = location;
+        const float speed = static_cast<float>(sqrt(step.x * step.x + step.y * step.y + step.z * step.z) / duration);
+        m_Speed += (speed - m_Speed) * OneEuroAlpha(oneEuroDerivativeCutoff, duration);
 
-        m_Ema = EmaFunction(location, m_Ema);
-        m_EmaEma = EmaFunction(m_Ema, m_EmaEma);
-        m_EmaEmaEma = EmaFunction(m_EmaEma, m_EmaEmaEma);
-        constexpr XrVector3f three{3, 3, 3};
-        location = three * m_Ema - three * m_EmaEma + m_EmaEmaEma;
+        const float adaption = m_Beta * m_Speed;
+        const XrVector3f alpha{OneEuroAlpha(m_MinCutoff.x + adaption, duration),
+                               OneEuroAlpha(m_MinCutoff.y + adaption, duration),
+                               OneEuroAlpha(m_MinCutoff.z + adaption, duration)};
+        m_Previous = m_Previous + alpha * (location - m_Previous);
+        location = m_Previous;
 
         TraceLoggingWriteStop(local,
-                              "TripleEmaFilter::ApplyFilter",
+                              "OneEuroTranslationFilter::ApplyFilter",
                               TLArg(xr::ToString(location).c_str(), "location"),
-                              TLArg(xr::ToString(this->m_Ema).c_str(), "m_Ema"),
-                              TLArg(xr::ToString(this->m_EmaEma).c_str(), "m_EmaEma"),
-                              TLArg(xr::ToString(this->m_EmaEmaEma).c_str(), "m_EmaEmaEma"));
+                              TLArg(m_Speed, "Speed"),
+                              TLArg(xr::ToString(alpha).c_str(), "Alpha"));
     }
 
-    void TripleEmaFilter::Reset(const XrVector3f& location)
+    void OneEuroTranslationFilter::Reset(const XrVector3f& location)
     {
-        DoubleEmaFilter::Reset(location);
-        m_EmaEmaEma = location;
+        m_Previous = m_PreviousInput = location;
+        m_Speed = 0.f;
+        m_LastTime = 0;
     }
 
-    void SingleSlerpFilter::ApplyFilter(XrQuaternionf& rotation)
+    OneEuroRotationFilter::OneEuroRotationFilter(const float strength) : FilterBase(strength, "rotational")
     {
         TraceLocalActivity(local);
-        TraceLoggingWriteStart(local,
-                               "SingleSlerpFilter::ApplyFilter",
-                               TLArg(xr::ToString(rotation).c_str(), "rotation"),
-                               TLArg(xr::ToString(this->m_FirstStage).c_str(), "m_FirstStage"),
-                               TLArg(std::to_string(this->m_Strength).c_str(), "m_Strength"));
+        TraceLoggingWriteStart(local, "OneEuroRotationFilter::OneEuroRotationFilter", TLArg(strength, "Strength"));
 
-        m_FirstStage = Quaternion::Slerp(rotation, m_FirstStage, m_Strength);
-        rotation = m_FirstStage;
+        GetConfig()->GetFloat(Cfg::RotBeta, m_Beta);
+        m_Beta = std::max(0.0f, m_Beta);
+        DebugLog("%s one euro filter beta set: %f", m_Type.c_str(), m_Beta);
+        OneEuroRotationFilter::SetStrength(m_Strength);
 
-        TraceLoggingWriteStop(local,
-                              "SingleSlerpFilter::ApplyFilter",
-                              TLArg(xr::ToString(rotation).c_str(), "rotation"),
-                              TLArg(xr::ToString(this->m_FirstStage).c_str(), "m_FirstStage"));
+        TraceLoggingWriteStop(local, "OneEuroRotationFilter::OneEuroRotationFilter", TLArg(m_Beta, "Beta"));
     }
 
-    void SingleSlerpFilter::Reset(const XrQuaternionf& rotation)
+    float OneEuroRotationFilter::SetStrength(const float strength)
     {
-        m_FirstStage = rotation;
+        FilterBase::SetStrength(strength);
+        m_MinCutoff = oneEuroMaxCutoff * (1.f - m_Strength);
+        return m_Strength;
     }
 
-    void DoubleSlerpFilter::ApplyFilter(XrQuaternionf& rotation)
+    void OneEuroRotationFilter::ApplyFilter(XrQuaternionf& rotation, const XrTime time)
     {
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local,
-                               "DoubleSlerpFilter::ApplyFilter",
+                               "OneEuroRotationFilter::ApplyFilter",
                                TLArg(xr::ToString(rotation).c_str(), "rotation"),
-                               TLArg(xr::ToString(this->m_FirstStage).c_str(), "m_FirstStage"),
-                               TLArg(xr::ToString(this->m_SecondStage).c_str(), "m_SecondStage"),
-                               TLArg(std::to_string(this->m_Strength).c_str(), "m_Strength"));
+                               TLArg(xr::ToString(this->m_Previous).c_str(), "m_Previous"),
+                               TLArg(time, "Time"));
 
-        m_FirstStage = Quaternion::Slerp(rotation, m_FirstStage, m_Strength);
-        m_SecondStage = Quaternion::Slerp(m_FirstStage, m_SecondStage, m_Strength);
-        rotation = m_SecondStage;
-
-        TraceLoggingWriteStop(local,
-                              "DoubleSlerpFilter::ApplyFilter",
-                              TLArg(xr::ToString(rotation).c_str(), "rotation"),
-                              TLArg(xr::ToString(this->m_FirstStage).c_str(), "m_FirstStage"),
-                              TLArg(xr::ToString(this->m_SecondStage).c_str(), "m_SecondStage"));
-    }
-
-    void DoubleSlerpFilter::Reset(const XrQuaternionf& rotation)
-    {
-        SingleSlerpFilter::Reset(rotation);
-        m_SecondStage = rotation;
-    }
+        if (!m_LastTime)
+        {
+            m_LastTime = time;
+            m_PreviousInput = rotation;
+        }
+        const double duration = (time - m_LastTime) / 1e9;
+        if (duration <= 0.0)
+        {
+            // no time elapsed (or earlier time requested)
+            rotation = m_Previous;
+            TraceLoggingWriteStop(local, "OneEuroRotationFilter::ApplyFilter", TLArg(duration, "Duration"));
+            return;
+        }
+        m_LastTime = time;
 
-    void TripleSlerpFilter::ApplyFilter(XrQuaternionf& rotation)
-    {
-        TraceLocalActivity(local);
-        TraceLoggingWriteStart(local,
-                               "TripleSlerpFilter::ApplyFilter",
-                               TLArg(xr::ToString(rotation).c_str(), "rotation"),
-                               TLArg(xr::ToString(this->m_FirstStage).c_str(), "m_FirstStage"),
-                               TLArg(xr::ToString(this->m_SecondStage).c_str(), "m_SecondStage"),
-                               TLArg(xr::ToString(this->m_ThirdStage).c_str(), "m_ThirdStage"),
-                               TLArg(std::to_string(this->m_Strength).c_str(), "m_Strength"));
+        // angular speed of the input in radian per second
+        const float dot = m_PreviousInput.x * rotation.x + m_PreviousInput.y * rotation.y +
+                          m_PreviousInput.z * rotation.z + m_PreviousInput.w * rotation.w;
+        m_PreviousInput = rotation;
+        const float speed = static_cast<float>(2.0 * acos(std::min(1.f, std::abs(dot))) / duration);
+        m_Speed += (speed - m_Speed) * OneEuroAlpha(oneEuroDerivativeCutoff, duration);
 
-        m_FirstStage = Quaternion::Slerp(rotation, m_FirstStage, m_Strength);
-        m_SecondStage = Quaternion::Slerp(m_FirstStage, m_SecondStage, m_Strength);
-        m_ThirdStage = Quaternion::Slerp(m_SecondStage, m_ThirdStage, m_Strength);
-        rotation = m_ThirdStage;
+        const float alpha = OneEuroAlpha(m_MinCutoff + m_Beta * m_Speed, duration);
+        m_Previous = Quaternion::Slerp(m_Previous, rotation, alpha);
+        rotation = m_Previous;
 
         TraceLoggingWriteStop(local,
-                              "TripleSlerpFilter::ApplyFilter",
+                              "OneEuroRotationFilter::ApplyFilter",
                               TLArg(xr::ToString(rotation).c_str(), "rotation"),
-                              TLArg(xr::ToString(this->m_FirstStage).c_str(), "m_FirstStage"),
-                              TLArg(xr::ToString(this->m_SecondStage).c_str(), "m_SecondStage"),
-                              TLArg(xr::ToString(this->m_ThirdStage).c_str(), "m_ThirdStage"));
+                              TLArg(m_Speed, "Speed"),
+                              TLArg(alpha, "Alpha"));
     }
 
-    void TripleSlerpFilter::Reset(const XrQuaternionf& rotation)
+    void OneEuroRotationFilter::Reset(const XrQuaternionf& rotation)
     {
-        SingleSlerpFilter::Reset(rotation);
-        m_ThirdStage = rotation;
+        m_Previous = m_PreviousInput = rotation;
+        m_Speed = 0.f;
+        m_LastTime = 0;
     }
 
     PassThroughStabilizer::PassThroughStabilizer(const std::vector<utility::DofValue>& relevant) : m_Relevant(relevant)
@@ -223,10 +236,15 @@ namespace filter
         SetFactor(Cfg::StabilizerPitch, pitch);
     }
 
-    void PassThroughStabilizer::Insert(const utility::Dof& dof, int64_t now)
+    void PassThroughStabilizer::InsertBatch(const std::span<const TimedDof> samples)
     {
+        if (samples.empty())
+        {
+            return;
+        }
         std::lock_guard lock(m_SampleMutex);
-        m_CurrentSample = dof;
+        m_CurrentSample = samples.back().dof;
+        Publish();
     }
 
     void PassThroughStabilizer::Read(utility::Dof& dof)
@@ -234,29 +252,51 @@ namespace filter
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local, "PassThroughStabilizer::Read", TLArg(xr::ToString(dof).c_str(), "DofIn"));
 
-        std::lock_guard lock(m_SampleMutex);
+        // lock-free access to avoid blocking the render thread on an ongoing sampling cycle
+        const Dof current = m_Published.Load();
         for (const DofValue value : m_Relevant)
         {
-            dof.data[value] = m_CurrentSample.data[value];
+            dof.data[value] = current.data[value];
         }
         TraceLoggingWriteStop(local, "PassThroughStabilizer::Read", TLArg(xr::ToString(dof).c_str(), "DofOut"));
     }
 
-    LowPassStabilizer::LowPassStabilizer(const std::vector<utility::DofValue>& relevant)
-        : PassThroughStabilizer(relevant)
+    void PassThroughStabilizer::Publish()
+    {
+        m_Published.Store(m_CurrentSample);
+    }
+
+    LowPassStabilizer::LowPassStabilizer(const std::vector<utility::DofValue>& relevant,
+                                         const double samplingRate,
+                                         const double cutoffScale)
+        : PassThroughStabilizer(relevant), m_SamplingRate(samplingRate), m_CutoffScale(cutoffScale)
     {
         TraceLocalActivity(local);
-        TraceLoggingWriteStart(local, "LowPassStabilizer::LowPassStabilizer");
+        TraceLoggingWriteStart(local, "LowPassStabilizer::LowPassStabilizer", TLArg(samplingRate, "SamplingRate"));
 
         float strength;
         GetConfig()->GetFloat(Cfg::StabilizerStrength, strength);
         strength = std::min(std::max(strength, 0.0f), 1.f);
         SetFrequencies(strength);
 
-        DebugLog("stabilizer strength: %.4f", strength);
+        DebugLog("stabilizer strength: %.4f, sampling rate: %.1f Hz", strength, m_SamplingRate);
+        GetConfig()->GetBool(Cfg::StabilizerResponse, m_WriteResponse);
         TraceLoggingWriteStop(local, "LowPassStabilizer::LowPassStabilizer");
     }
 
+    std::vector<FrequencyResponse> LowPassStabilizer::GetFrequencyResponse(const utility::DofValue value,
+                                                                           const std::vector<float>& frequencies)
+    {
+        std::lock_guard lock(m_SampleMutex);
+        return EvaluateResponse(value, frequencies);
+    }
+
+    float LowPassStabilizer::GetCutoff(const utility::DofValue value)
+    {
+        std::lock_guard lock(m_SampleMutex);
+        return m_Frequency.data[value];
+    }
+
     void LowPassStabilizer::SetFrequencies(float strength)
     {
         TraceLocalActivity(local);
@@ -283,7 +323,8 @@ namespace filter
             }
             else
             {
-                m_Frequency.data[value] = static_cast<float>(12.5 / (2 * withFactor + 0.1) - 12.5 / 2.1);
+                m_Frequency.data[value] =
+                    static_cast<float>((12.5 / (2 * withFactor + 0.1) - 12.5 / 2.1) * m_CutoffScale);
             }
             DebugLog("stabilizer low pass frequency(%u) = %f", value, m_Frequency.data[value]);
             TraceLoggingWriteTagged(local,
@@ -313,6 +354,101 @@ namespace filter
         return m_Disabled;
     }
 
+    std::vector<FrequencyResponse> LowPassStabilizer::EvaluateResponse(const utility::DofValue value,
+                                                                       const std::vector<float>& frequencies) const
+    {
+        std::vector<FrequencyResponse> response;
+        if (m_Blocking || (!m_Disabled && m_Frequency.data[value] == 0.f))
+        {
+            // output is held at zero: no gain, phase and delay are meaningless
+            for (const float frequency : frequencies)
+            {
+                response.push_back({frequency, -std::numeric_limits<float>::infinity(), 0.f, 0.f});
+            }
+            return response;
+        }
+        double b[3]{1.0, 0.0, 0.0}, a[3]{1.0, 0.0, 0.0};
+        if (!m_Disabled && m_Frequency.data[value] > 0.f)
+        {
+            GetTransferFunction(m_Frequency.data[value], b, a);
+        }
+        double previousPhase{0.0};
+        for (const float frequency : frequencies)
+        {
+            // evaluate H(z) = B(z) / A(z) at z = e^(j * omega)
+            const double omega = 2.0 * M_PI * frequency / m_SamplingRate;
+            std::complex<double> numerator{}, denominator{}, numeratorSlope{}, denominatorSlope{};
+            for (int k = 0; k < 3; k++)
+            {
+                const std::complex<double> delay = std::polar(1.0, -k * omega);
+                numerator += b[k] * delay;
+                denominator += a[k] * delay;
+                numeratorSlope += static_cast<double>(k) * b[k] * delay;
+                denominatorSlope += static_cast<double>(k) * a[k] * delay;
+            }
+            const std::complex<double> transfer = numerator / denominator;
+
+            // unwrap phase along frequency sweep
+            double phase = std::arg(transfer);
+            phase -= 2.0 * M_PI * std::round((phase - previousPhase) / (2.0 * M_PI));
+            previousPhase = phase;
+
+            // group delay in samples: Re(z * B'(z) / B(z)) - Re(z * A'(z) / A(z))
+            const double groupDelay = (numeratorSlope / numerator).real() - (denominatorSlope / denominator).real();
+
+            response.push_back({frequency,
+                                static_cast<float>(20.0 * log10(std::abs(transfer))),
+                                static_cast<float>(phase * 180.0 / M_PI),
+                                static_cast<float>(groupDelay * 1000.0 / m_SamplingRate)});
+        }
+        return response;
+    }
+
+    void LowPassStabilizer::WriteFrequencyResponse() const
+    {
+        if (!m_WriteResponse)
+        {
+            return;
+        }
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "LowPassStabilizer::WriteFrequencyResponse");
+
+        // logarithmic sweep from 0.1 Hz to 100 Hz
+        std::vector<float> frequencies;
+        for (int i = 0; i <= 60; i++)
+        {
+            frequencies.push_back(0.1f * powf(10.f, i / 20.f));
+        }
+
+        const std::string fileName = (openxr_api_layer::localAppData / "stabilizer_response.csv").string();
+        std::ofstream file(fileName, std::ios_base::trunc);
+        if (!file.is_open())
+        {
+            ErrorLog("%s: unable to open output file: %s", __FUNCTION__, fileName.c_str());
+            TraceLoggingWriteStop(local, "LowPassStabilizer::WriteFrequencyResponse", TLArg(false, "Success"));
+            return;
+        }
+        constexpr const char* names[]{"Sway", "Surge", "Heave", "Yaw", "Roll", "Pitch"};
+        file << "Dof;Cutoff;Frequency;Magnitude;Phase;GroupDelay\n";
+        for (const DofValue value : m_Relevant)
+        {
+            for (const auto& [frequency, magnitude, phase, groupDelay] : EvaluateResponse(value, frequencies))
+            {
+                file << names[value] << ";" << m_Frequency.data[value] << ";" << frequency << ";" << magnitude << ";"
+                     << phase << ";" << groupDelay << "\n";
+            }
+        }
+        Log("stabilizer frequency response written to: %s", fileName.c_str());
+
+        TraceLoggingWriteStop(local, "LowPassStabilizer::WriteFrequencyResponse", TLArg(true, "Success"));
+    }
+
+    EmaStabilizer::EmaStabilizer(const std::vector<utility::DofValue>& relevant, const double samplingRate)
+        : LowPassStabilizer(relevant, samplingRate)
+    {
+        WriteFrequencyResponse();
+    }
+
     void EmaStabilizer::SetStrength(const float strength)
     {
         TraceLocalActivity(local);
@@ -320,10 +456,19 @@ namespace filter
 
         std::lock_guard lock(m_SampleMutex);
         SetFrequencies(strength);
+        WriteFrequencyResponse();
 
         TraceLoggingWriteStop(local, "EmaStabilizer::SetStrength");
     }
 
+    void EmaStabilizer::GetTransferFunction(const float frequency, double (&b)[3], double (&a)[3]) const
+    {
+        // y = y + (x - y) * k
+        const double factor = 1.0 - exp(-2.0 * M_PI * frequency / m_SamplingRate);
+        b[0] = factor;
+        a[1] = factor - 1.0;
+    }
+
     void EmaStabilizer::SetStartTime(int64_t now)
     {
         TraceLocalActivity(local);
@@ -336,18 +481,30 @@ namespace filter
         TraceLoggingWriteStop(local, "EmaStabilizer::SetStartTime");
     }
 
-    void EmaStabilizer::Insert(const utility::Dof& dof, int64_t now)
+    void EmaStabilizer::InsertBatch(const std::span<const TimedDof> samples)
     {
         TraceLocalActivity(local);
-        TraceLoggingWriteStart(local,
-                               "EmaStabilizer::Insert",
-                               TLArg(xr::ToString(dof).c_str(), "Sample"),
-                               TLArg(now, "Now"));
+        TraceLoggingWriteStart(local, "EmaStabilizer::InsertBatch", TLArg(samples.size(), "Samples"));
 
         std::lock_guard lock(m_SampleMutex);
+        for (const auto& [dof, now] : samples)
+        {
+            InsertSample(dof, now);
+        }
+        Publish();
+
+        TraceLoggingWriteStop(local, "EmaStabilizer::InsertBatch");
+    }
+
+    void EmaStabilizer::InsertSample(const utility::Dof& dof, const int64_t now)
+    {
+        TraceLoggingWrite(g_traceProvider,
+                          "EmaStabilizer::InsertSample",
+                          TLArg(xr::ToString(dof).c_str(), "Sample"),
+                          TLArg(now, "Now"));
+
         if (Disabled(dof))
         {
-            TraceLoggingWriteStop(local, "EmaStabilizer::Insert", TLArg(true, "Disabled"));
             return;
         }
 
@@ -359,7 +516,6 @@ namespace filter
                 m_CurrentSample.data[value] = m_Frequency.data[value] == 0.f ? 0.f : dof.data[value];
             }
             m_Initialized = true;
-            TraceLoggingWriteStop(local, "EmaStabilizer::Insert", TLArg(true, "InitialSample"));
             return;
         }
 
@@ -369,21 +525,101 @@ namespace filter
             if (m_Frequency.data[value] == -1.f)
             {
                 m_CurrentSample.data[value] = dof.data[value];
-                TraceLoggingWriteTagged(local,
-                                        "EmaStabilizer::Insert",
-                                        TLArg(static_cast<int>(value), "Value"),
-                                        TLArg(true, "Disabled"));
                 continue;
             }
             const float factor = static_cast<float>(1 - exp(durationFactor * m_Frequency.data[value]));
             m_CurrentSample.data[value] += (dof.data[value] - m_CurrentSample.data[value]) * factor;
-            TraceLoggingWriteTagged(local,
-                                    "EmaStabilizer::Insert",
-                                    TLArg(static_cast<int>(value), "Value"),
-                                    TLArg(factor, "Factor"),
-                                    TLArg(this->m_CurrentSample.data[value], "Current_Sample"));
+            TraceLoggingWrite(g_traceProvider,
+                              "EmaStabilizer::InsertSample",
+                              TLArg(static_cast<int>(value), "Value"),
+                              TLArg(factor, "Factor"),
+                              TLArg(this->m_CurrentSample.data[value], "Current_Sample"));
+        }
+    }
+
+    namespace
+    {
+        // maximum length of filtered rotation vector (radian) before anchor is moved
+        constexpr double rotationRecenterThreshold{0.05};
+
+        // unit quaternion in double precision
+        struct Rotation
+        {
+            double w{1.0}, x{}, y{}, z{};
+        };
+
+        Rotation Multiply(const Rotation& a, const Rotation& b)
+        {
+            return {a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+                    a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+                    a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+                    a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w};
+        }
+
+        // yaw (y-axis), pitch (x-axis) and roll (z-axis) in degrees, same convention as utility::ToEulerAngles
+        Rotation FromAngles(const double yaw, const double pitch, const double roll)
+        {
+            const double halfYaw = yaw * M_PI / 360.0, halfPitch = pitch * M_PI / 360.0, halfRoll = roll * M_PI / 360.0;
+            const double cy = cos(halfYaw), sy = sin(halfYaw);
+            const double cp = cos(halfPitch), sp = sin(halfPitch);
+            const double cr = cos(halfRoll), sr = sin(halfRoll);
+            return {cy * cp * cr + sy * sp * sr,
+                    cy * sp * cr + sy * cp * sr,
+                    sy * cp * cr - cy * sp * sr,
+                    cy * cp * sr - sy * sp * cr};
+        }
+
+        void FromRotation(const Rotation& q, double& yaw, double& pitch, double& roll)
+        {
+            pitch = asin(std::clamp(2.0 * (q.w * q.x - q.z * q.y), -1.0, 1.0)) * 180.0 / M_PI;
+            yaw = atan2(2.0 * (q.w * q.y + q.z * q.x), 1.0 - 2.0 * (q.x * q.x + q.y * q.y)) * 180.0 / M_PI;
+            roll = atan2(2.0 * (q.w * q.z + q.x * q.y), 1.0 - 2.0 * (q.z * q.z + q.x * q.x)) * 180.0 / M_PI;
+        }
+
+        // logarithmic map: rotation axis scaled by angle (radian), using shortest path
+        std::array<double, 3> ToRotationVector(const Rotation& q)
+        {
+            const double sign = q.w < 0.0 ? -1.0 : 1.0;
+            const double squared = q.x * q.x + q.y * q.y + q.z * q.z;
+            double scale;
+            if (squared < rotationRecenterThreshold * rotationRecenterThreshold)
+            {
+                // rotation relative to anchor is small: series of asin(length) / length, relative error < 1e-9
+                scale = 2.0 * sign * (1.0 + squared / 6.0 + squared * squared * 3.0 / 40.0);
+            }
+            else
+            {
+                const double length = sqrt(squared);
+                scale = 2.0 * atan2(length, sign * q.w) * sign / length;
+            }
+            return {q.x * scale, q.y * scale, q.z * scale};
         }
-        TraceLoggingWriteStop(local, "EmaStabilizer::Insert");
+
+        // exponential map: inverse of ToRotationVector
+        Rotation FromRotationVector(const double (&vector)[3])
+        {
+            const double squared = vector[0] * vector[0] + vector[1] * vector[1] + vector[2] * vector[2];
+            if (squared < rotationRecenterThreshold * rotationRecenterThreshold)
+            {
+                // filtered offset stays below recenter threshold: series of cos(angle / 2) and sin(angle / 2) / angle
+                const double scale = 0.5 - squared / 48.0 + squared * squared / 3840.0;
+                return {1.0 - squared / 8.0 + squared * squared / 384.0,
+                        vector[0] * scale,
+                        vector[1] * scale,
+                        vector[2] * scale};
+            }
+            const double angle = sqrt(squared);
+            const double scale = sin(angle / 2.0) / angle;
+            return {cos(angle / 2.0), vector[0] * scale, vector[1] * scale, vector[2] * scale};
+        }
+    } // namespace
+
+    BiQuadStabilizer::BiQuadStabilizer(const std::vector<utility::DofValue>& relevant, const double samplingRate)
+        : LowPassStabilizer(relevant, samplingRate, m_LegacyCutoffScale)
+    {
+        GetConfig()->GetBool(Cfg::StabilizerAdaptiveRate, m_AdaptiveRate);
+        DebugLog("stabilizer sampling rate adaption: %s", m_AdaptiveRate ? "on" : "off");
+        WriteFrequencyResponse();
     }
 
     void BiQuadStabilizer::SetStrength(float strength)
@@ -394,64 +630,153 @@ namespace filter
         std::lock_guard lock(m_SampleMutex);
         SetFrequencies(strength);
         ResetFilters();
+        WriteFrequencyResponse();
 
         TraceLoggingWriteStop(local, "BiQuadStabilizer::SetStrength");
     }
 
+    void BiQuadStabilizer::GetTransferFunction(const float frequency, double (&b)[3], double (&a)[3]) const
+    {
+        // y = a * (x + 2 * x1 + x2) + d1 * y1 + d2 * y2
+        const auto [gain, d1, d2] = BiQuadBank::Design(frequency, m_SamplingRate);
+        b[0] = gain;
+        b[1] = 2.0 * gain;
+        b[2] = gain;
+        a[1] = -d1;
+        a[2] = -d2;
+    }
+
     void BiQuadStabilizer::SetStartTime(int64_t now)
     {
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local, "BiQuadStabilizer::SetStartTime", TLArg(now, "Now"));
 
         std::lock_guard lock(m_SampleMutex);
+        m_LastSampleTime = now;
         ResetFilters();
 
         TraceLoggingWriteStop(local, "BiQuadStabilizer::SetStartTime");
     }
 
-    void BiQuadStabilizer::Insert(const utility::Dof& dof, int64_t now)
+    void BiQuadStabilizer::InsertBatch(const std::span<const TimedDof> samples)
     {
         TraceLocalActivity(local);
-        TraceLoggingWriteStart(local,
-                               "BiQuadStabilizer::Insert",
-                               TLArg(xr::ToString(dof).c_str(), "Sample"),
-                               TLArg(now, "Now"));
+        TraceLoggingWriteStart(local, "BiQuadStabilizer::InsertBatch", TLArg(samples.size(), "Samples"));
 
         std::lock_guard lock(m_SampleMutex);
+        for (const auto& [dof, now] : samples)
+        {
+            InsertSample(dof, now);
+        }
+        Publish();
+
+        TraceLoggingWriteStop(local, "BiQuadStabilizer::InsertBatch");
+    }
+
+    void BiQuadStabilizer::InsertSample(const utility::Dof& dof, const int64_t now)
+    {
+        TraceLoggingWrite(g_traceProvider,
+                          "BiQuadStabilizer::InsertSample",
+                          TLArg(xr::ToString(dof).c_str(), "Sample"),
+                          TLArg(now, "Now"));
+
         if (Disabled(dof))
         {
-            TraceLoggingWriteStop(local, "BiQuadStabilizer::Insert", TLArg(true, "Disabled"));
             return;
         }
 
+        double channels[BiQuadBank::m_Channels]{};
         for (const DofValue value : m_Relevant)
         {
-            if (m_Frequency.data[value] == -1.f)
+            if (value < yaw)
             {
-                m_CurrentSample.data[value] = dof.data[value];
-                TraceLoggingWriteTagged(local,
-                                        "BiQuadStabilizer::Insert",
-                                        TLArg(static_cast<int>(value), "Value"),
-                                        TLArg(true, "Disabled"));
-                continue;
+                channels[value] = dof.data[value];
+            }
+        }
+        if (m_Rotational)
+        {
+            // filter orientation relative to anchor as rotation vector instead of individual angles
+            // held axes (frequency 0) don't contribute, like their translational counterparts
+            double source[6]{};
+            for (const DofValue value : m_Relevant)
+            {
+                source[value] = value < yaw || m_Frequency.data[value] == 0.f ? 0.0 : dof.data[value];
             }
+            const Rotation current = FromAngles(source[yaw], source[pitch], source[roll]);
             if (!m_Initialized)
             {
-                // skip attack time
-                for (int i = 0; i < 1e5; i++)
+                m_Anchor[0] = current.w, m_Anchor[1] = current.x, m_Anchor[2] = current.y, m_Anchor[3] = current.z;
+            }
+            const Rotation inverseAnchor{m_Anchor[0], -m_Anchor[1], -m_Anchor[2], -m_Anchor[3]};
+            const std::array<double, 3> vector = ToRotationVector(Multiply(inverseAnchor, current));
+
+            // x, y and z component of rotation vector correspond to pitch, yaw and roll axis
+            channels[pitch] = vector[0];
+            channels[yaw] = vector[1];
+            channels[roll] = vector[2];
+        }
+        double input[BiQuadBank::m_Channels];
+        std::copy(std::begin(channels), std::end(channels), std::begin(input));
+
+        if (!m_Initialized)
+        {
+            // skip attack time
+            m_Bank.Prime(channels);
+            m_LastSampleTime = now;
+        }
+        else if (m_AdaptiveRate)
+        {
+            UpdateCoefficients(now);
+        }
+        m_Bank.Filter(channels);
+
+        double angles[6]{};
+        if (m_Rotational)
+        {
+            for (const DofValue value : m_Relevant)
+            {
+                if (value >= yaw && m_Frequency.data[value] == -1.f)
                 {
-                    Filter(dof.data[value], value);
+                    // unfiltered axis
+                    channels[value] = input[value];
                 }
             }
-            m_CurrentSample.data[value] = static_cast<float>(Filter(dof.data[value], value));
-            TraceLoggingWriteTagged(local,
-                                    "BiQuadStabilizer::Insert",
-                                    TLArg(static_cast<int>(value), "Value"),
-                                    TLArg(this->m_CurrentSample.data[value], "Current_Sample"));
+            const double offset[3]{channels[pitch], channels[yaw], channels[roll]};
+            const Rotation anchor{m_Anchor[0], m_Anchor[1], m_Anchor[2], m_Anchor[3]};
+            const Rotation filtered = Multiply(anchor, FromRotationVector(offset));
+            FromRotation(filtered, angles[yaw], angles[pitch], angles[roll]);
+
+            if (offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2] >
+                rotationRecenterThreshold * rotationRecenterThreshold)
+            {
+                // move anchor to filtered orientation to keep rotation vector small
+                m_Anchor[0] = filtered.w, m_Anchor[1] = filtered.x, m_Anchor[2] = filtered.y, m_Anchor[3] = filtered.z;
+                m_Bank.Shift(pitch, offset[0]);
+                m_Bank.Shift(yaw, offset[1]);
+                m_Bank.Shift(roll, offset[2]);
+            }
+        }
+
+        for (const DofValue value : m_Relevant)
+        {
+            if (m_Frequency.data[value] == -1.f)
+            {
+                m_CurrentSample.data[value] = dof.data[value];
+                continue;
+            }
+            if (m_Frequency.data[value] == 0.f)
+            {
+                // held channel, zero coefficients only apply to the rotation vector component
+                m_CurrentSample.data[value] = 0.f;
+                continue;
+            }
+            m_CurrentSample.data[value] = static_cast<float>(value < yaw ? channels[value] : angles[value]);
         }
         m_Initialized = true;
 
-        TraceLoggingWriteStop(local, "BiQuadStabilizer::Insert");
+        TraceLoggingWrite(g_traceProvider,
+                          "BiQuadStabilizer::InsertSample",
+                          TLArg(xr::ToString(m_CurrentSample).c_str(), "Current_Sample"));
     }
 
     void BiQuadStabilizer::ResetFilters()
@@ -459,54 +784,446 @@ namespace filter
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local, "BiQuadStabilizer::ResetFilters");
 
+        m_Bank = {};
+        std::set<float> frequencies;
+        m_Rotational = false;
         for (const DofValue value : m_Relevant)
         {
-            m_Filter[value] = std::make_unique<BiQuadFilter>(BiQuadFilter(m_Frequency.data[value]));
-            if (value >= yaw)
+            m_Bank.SetFrequency(value, m_Frequency.data[value], m_SamplingRate);
+            m_Rotational |= value >= yaw;
+            if (m_AdaptiveRate && m_Frequency.data[value] > 0.f)
             {
-                m_Filter[value + 3] = std::make_unique<BiQuadFilter>(BiQuadFilter(m_Frequency.data[value]));
+                m_Table[value] = m_CoefficientCache.GetTable(m_Frequency.data[value]);
+                frequencies.insert(m_Frequency.data[value]);
+            }
+            else
+            {
+                m_Table[value] = nullptr;
             }
         }
+        m_CoefficientCache.Retain(frequencies);
+        m_Interval.Reset(1e9 / m_SamplingRate);
         m_Initialized = false;
 
         TraceLoggingWriteStop(local, "BiQuadStabilizer::ResetFilters");
     }
 
-    double BiQuadStabilizer::Filter(float dofValue, utility::DofValue value) const
+    void BiQuadStabilizer::UpdateCoefficients(const int64_t now)
+    {
+        const int64_t interval = now - m_LastSampleTime;
+        if (interval <= 0)
+        {
+            // keep coefficients of previous interval, resync to continue adapting after time base jumped backwards
+            m_LastSampleTime = now;
+            return;
+        }
+        m_LastSampleTime = now;
+
+        const double average = m_Interval.Update(interval);
+        const size_t index = CoefficientCache::ToIndex(std::llround(average));
+        for (const DofValue value : m_Relevant)
+        {
+            if (!m_Table[value])
+            {
+                continue;
+            }
+            m_Bank.SetCoefficients(value, m_Table[value][index]);
+        }
+        TraceLoggingWrite(g_traceProvider,
+                          "BiQuadStabilizer::UpdateCoefficients",
+                          TLArg(interval, "Interval"),
+                          TLArg(average, "Average"),
+                          TLArg(index, "Index"));
+    }
+
+    const BiQuadBank::Coefficients* BiQuadStabilizer::CoefficientCache::GetTable(const float frequency)
+    {
+        auto& table = m_Tables[frequency];
+        if (table.empty())
+        {
+            table.reserve(m_Intervals);
+            table.push_back(BiQuadBank::Coefficients{});
+            for (size_t i = 1; i < m_Intervals; i++)
+            {
+                table.push_back(BiQuadBank::Design(frequency, 1e9 / static_cast<double>(i * m_Resolution)));
+            }
+            DebugLog("stabilizer coefficient table created for frequency: %f", frequency);
+        }
+        return table.data();
+    }
+
+    void BiQuadStabilizer::CoefficientCache::Retain(const std::set<float>& frequencies)
+    {
+        std::erase_if(m_Tables, [&frequencies](const auto& entry) { return !frequencies.contains(entry.first); });
+    }
+
+    size_t BiQuadStabilizer::CoefficientCache::ToIndex(const int64_t interval)
+    {
+        const int64_t index = (interval + m_Resolution / 2) / m_Resolution;
+        return static_cast<size_t>(std::clamp(index, int64_t{1}, static_cast<int64_t>(m_Intervals) - 1));
+    }
+
+    namespace
+    {
+        // process noise (white jerk) relative to measurement noise, input is already low pass filtered
+        constexpr double kalmanProcessNoise{1e9};
+        constexpr double kalmanMeasurementNoise{1.0};
+        // maximum gap between samples before the estimation is restarted
+        constexpr int64_t kalmanMaxInterval{100000000};
+
+        double WrapAngle(const double angle)
+        {
+            const double wrapped = fmod(angle + 180.0, 360.0);
+            return wrapped < 0.0 ? wrapped + 180.0 : wrapped - 180.0;
+        }
+    } // namespace
+
+    KalmanPredictor::KalmanPredictor(const std::vector<utility::DofValue>& relevant, const int64_t maxHorizon)
+        : m_Relevant(relevant), m_MaxHorizon(maxHorizon)
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "KalmanPredictor::KalmanPredictor");
+        TraceLoggingWriteStop(local, "KalmanPredictor::KalmanPredictor", TLArg(m_MaxHorizon, "MaxHorizon"));
+    }
+
+    void KalmanPredictor::Reset()
+    {
+        m_LastTime = 0;
+        m_Published.Store({});
+    }
+
+    void KalmanPredictor::Update(const Dof& dof, const int64_t now)
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "KalmanPredictor::Update", TLArg(now, "Now"));
+
+        const int64_t interval = now - m_LastTime;
+        if (0 != m_LastTime && 0 >= interval)
+        {
+            TraceLoggingWriteStop(local, "KalmanPredictor::Update", TLArg(interval, "Skipped"));
+            return;
+        }
+        Estimate estimate{};
+        estimate.time = now;
+        if (0 == m_LastTime || kalmanMaxInterval < interval)
+        {
+            // (re)start estimation at current position without motion
+            for (const DofValue value : m_Relevant)
+            {
+                State& state = m_States[value];
+                state = {};
+                state.x[0] = dof.data[value];
+                // initial uncertainty of position, velocity and acceleration
+                state.p[0][0] = kalmanMeasurementNoise;
+                state.p[1][1] = 1e4;
+                state.p[2][2] = 1e6;
+                estimate.position[value] = dof.data[value];
+            }
+            m_LastTime = now;
+            m_Published.Store(estimate);
+            TraceLoggingWriteStop(local, "KalmanPredictor::Update", TLArg(true, "Restart"));
+            return;
+        }
+        m_LastTime = now;
+
+        const double dt = interval / 1e9;
+        const double dt2 = dt * dt, dt3 = dt2 * dt, dt4 = dt3 * dt, dt5 = dt4 * dt;
+        const double transition[3][3]{{1.0, dt, dt2 / 2.0}, {0.0, 1.0, dt}, {0.0, 0.0, 1.0}};
+        const double noise[3][3]{{dt5 / 20.0, dt4 / 8.0, dt3 / 6.0},
+                                 {dt4 / 8.0, dt3 / 3.0, dt2 / 2.0},
+                                 {dt3 / 6.0, dt2 / 2.0, dt}};
+        for (const DofValue value : m_Relevant)
+        {
+            State& state = m_States[value];
+
+            // predict state and covariance: x = F * x, P = F * P * F^T + Q
+            const double x[3]{state.x[0] + state.x[1] * dt + state.x[2] * dt2 / 2.0,
+                              state.x[1] + state.x[2] * dt,
+                              state.x[2]};
+            double fp[3][3]{}, p[3][3]{};
+            for (int i = 0; i < 3; i++)
+            {
+                for (int j = 0; j < 3; j++)
+                {
+                    for (int k = 0; k < 3; k++)
+                    {
+                        fp[i][j] += transition[i][k] * state.p[k][j];
+                    }
+                }
+            }
+            for (int i = 0; i < 3; i++)
+            {
+                for (int j = 0; j < 3; j++)
+                {
+                    for (int k = 0; k < 3; k++)
+                    {
+                        p[i][j] += fp[i][k] * transition[j][k];
+                    }
+                    p[i][j] += kalmanProcessNoise * noise[i][j];
+                }
+            }
+
+            // correct with measured position
+            double innovation = dof.data[value] - x[0];
+            if (value > heave)
+            {
+                innovation = WrapAngle(innovation);
+            }
+            const double residual = p[0][0] + kalmanMeasurementNoise;
+            const double gain[3]{p[0][0] / residual, p[1][0] / residual, p[2][0] / residual};
+            for (int i = 0; i < 3; i++)
+            {
+                state.x[i] = x[i] + gain[i] * innovation;
+                for (int j = 0; j < 3; j++)
+                {
+                    state.p[i][j] = p[i][j] - gain[i] * p[0][j];
+                }
+            }
+            if (value > heave)
+            {
+                state.x[0] = WrapAngle(state.x[0]);
+            }
+
+            estimate.position[value] = static_cast<float>(state.x[0]);
+            estimate.velocity[value] = static_cast<float>(state.x[1]);
+            estimate.acceleration[value] = static_cast<float>(state.x[2]);
+        }
+        m_Published.Store(estimate);
+
+        TraceLoggingWriteStop(local, "KalmanPredictor::Update");
+    }
+
+    void KalmanPredictor::Predict(Dof& dof, const int64_t time) const
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "KalmanPredictor::Predict", TLArg(time, "Time"));
+
+        const Estimate estimate = m_Published.Load();
+        if (0 == estimate.time)
+        {
+            TraceLoggingWriteStop(local, "KalmanPredictor::Predict", TLArg(false, "Valid"));
+            return;
+        }
+        const double horizon = std::clamp(time - estimate.time, int64_t{0}, m_MaxHorizon) / 1e9;
+        for (const DofValue value : m_Relevant)
+        {
+            double predicted = estimate.position[value] + estimate.velocity[value] * horizon +
+                               estimate.acceleration[value] * horizon * horizon / 2.0;
+            if (value > heave)
+            {
+                predicted = WrapAngle(predicted);
+            }
+            dof.data[value] = static_cast<float>(predicted);
+        }
+
+        TraceLoggingWriteStop(local,
+                              "KalmanPredictor::Predict",
+                              TLArg(horizon, "Horizon"),
+                              TLArg(xr::ToString(dof).c_str(), "Dof"));
+    }
+
+    Decimator::Decimator(const int factor)
+        : m_Factor(static_cast<size_t>(factor)), m_Taps(m_TapsPerPhase * m_Factor),
+          m_Coefficients(m_Taps), m_History(2 * m_Taps * m_Channels)
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "Decimator::Decimator", TLArg(factor, "Factor"));
+
+        // blackman windowed sinc with cutoff at output nyquist frequency
+        const double cutoff = 0.5 / static_cast<double>(m_Factor);
+        const double center = (static_cast<double>(m_Taps) - 1.0) / 2.0;
+        double sum{0.0};
+        for (size_t i = 0; i < m_Taps; i++)
+        {
+            const double x = 2.0 * cutoff * (static_cast<double>(i) - center);
+            const double sinc = x == 0.0 ? 1.0 : sin(M_PI * x) / (M_PI * x);
+            const double phase = 2.0 * M_PI * (static_cast<double>(i) + 0.5) / static_cast<double>(m_Taps);
+            const double window = 0.42 - 0.5 * cos(phase) + 0.08 * cos(2.0 * phase);
+            m_Coefficients[i] = sinc * window;
+            sum += m_Coefficients[i];
+        }
+        for (double& coefficient : m_Coefficients)
+        {
+            // unity gain for constant input
+            coefficient /= sum;
+        }
+        DebugLog("decimator: factor = %zu, taps = %zu, delay = %.2f samples", m_Factor, m_Taps, center);
+
+        TraceLoggingWriteStop(local, "Decimator::Decimator", TLArg(m_Taps, "Taps"));
+    }
+
+    void Decimator::Reset()
+    {
+        m_Initialized = false;
+    }
+
+    bool Decimator::Push(const TimedDof& sample, TimedDof& output)
+    {
+        double row[m_Channels]{};
+        for (int value = sway; value <= pitch; value++)
+        {
+            row[value] = sample.dof.data[value];
+        }
+        for (int angle = 0; angle < 3; angle++)
+        {
+            const double current = sample.dof.data[yaw + angle];
+            m_Unwrapped[angle] =
+                m_Initialized ? m_Unwrapped[angle] + WrapAngle(current - m_LastAngle[angle]) : current;
+            m_LastAngle[angle] = current;
+            row[yaw + angle] = m_Unwrapped[angle];
+        }
+
+        if (!m_Initialized)
+        {
+            // fill history with first sample to avoid attack
+            for (size_t i = 0; i < 2 * m_Taps; i++)
+            {
+                std::copy(std::begin(row), std::end(row), m_History.begin() + i * m_Channels);
+            }
+            m_Position = 0;
+            m_Phase = 0;
+            m_Initialized = true;
+        }
+        else
+        {
+            m_Position = (m_Position + 1) % m_Taps;
+            std::copy(std::begin(row), std::end(row), m_History.begin() + m_Position * m_Channels);
+            std::copy(std::begin(row), std::end(row), m_History.begin() + (m_Position + m_Taps) * m_Channels);
+        }
+
+        if (++m_Phase < m_Factor)
+        {
+            return false;
+        }
+        m_Phase = 0;
+
+        // newest sample is last row of the window
+        double sum[m_Channels]{};
+        Convolve(m_History.data() + (m_Position + 1) * m_Channels, sum);
+
+        output.time = sample.time;
+        for (int value = sway; value <= pitch; value++)
+        {
+            output.dof.data[value] =
+                static_cast<float>(value < yaw ? sum[value] : WrapAngle(sum[value]));
+        }
+        return true;
+    }
+
+    void Decimator::Convolve(const double* window, double (&sum)[m_Channels]) const
+    {
+        // coefficients are symmetric, so the window can be traversed oldest to newest
+#if defined(FILTER_AVX)
+        __m256d low = _mm256_setzero_pd(), high = _mm256_setzero_pd();
+        for (size_t i = 0; i < m_Taps; i++, window += m_Channels)
+        {
+            const __m256d coefficient = _mm256_set1_pd(m_Coefficients[i]);
+            low = _mm256_add_pd(low, _mm256_mul_pd(coefficient, _mm256_loadu_pd(window)));
+            high = _mm256_add_pd(high, _mm256_mul_pd(coefficient, _mm256_loadu_pd(window + 4)));
+        }
+        _mm256_storeu_pd(sum, low);
+        _mm256_storeu_pd(sum + 4, high);
+#elif defined(FILTER_SSE2)
+        __m128d accumulator[m_Channels / 2]{};
+        for (size_t i = 0; i < m_Taps; i++, window += m_Channels)
+        {
+            const __m128d coefficient = _mm_set1_pd(m_Coefficients[i]);
+            for (size_t j = 0; j < m_Channels / 2; j++)
+            {
+                accumulator[j] = _mm_add_pd(accumulator[j], _mm_mul_pd(coefficient, _mm_loadu_pd(window + 2 * j)));
+            }
+        }
+        for (size_t j = 0; j < m_Channels / 2; j++)
+        {
+            _mm_storeu_pd(sum + 2 * j, accumulator[j]);
+        }
+#else
+        for (size_t i = 0; i < m_Taps; i++, window += m_Channels)
+        {
+            for (size_t j = 0; j < m_Channels; j++)
+            {
+                sum[j] += m_Coefficients[i] * window[j];
+            }
+        }
+#endif
+    }
+
+    void SampleHistory::Reset()
+    {
+        m_Count.store(0, std::memory_order_release);
+    }
+
+    void SampleHistory::Store(const TimedDof& sample)
     {
-        if (value < yaw)
+        const size_t count = m_Count.load(std::memory_order_relaxed);
+        if (count > 0 && sample.time <= m_Slots[(count - 1) % m_Capacity].Load().time)
         {
-            return m_Filter[value]->Filter(dofValue);
+            // keep history strictly ordered
+            return;
         }
-        // avoid jump when going from -180 to 180 degrees and vice versa
+        m_Slots[count % m_Capacity].Store(sample);
+        m_Count.store(count + 1, std::memory_order_release);
+    }
 
-        // angle to radian (between pi and -pi
-        double radian = dofValue / 180.0 * M_PI;
-        radian = fmod(radian + M_PI, 2.0 * M_PI);
-        radian += radian > 0 ? -M_PI : M_PI;
+    void SampleHistory::SetMaxExtrapolation(const int64_t duration)
+    {
+        m_MaxExtrapolation = duration;
+    }
 
-        // use complex numbers to decompose radian angle into sine and cosine
-        const std::complex<double> complex = std::polar(1.0, radian);
-        const double real = m_Filter[value]->Filter(complex.real());
-        const double imag = m_Filter[value + 3]->Filter(complex.imag());
-        return std::arg(std::complex<double>{real, imag}) * 180.0 / M_PI;
+    bool SampleHistory::Get(const int64_t time, Dof& dof) const
+    {
+        const size_t count = m_Count.load(std::memory_order_acquire);
+        if (0 == count)
+        {
+            return false;
+        }
+        TimedDof newer = m_Slots[(count - 1) % m_Capacity].Load();
+        if (time >= newer.time)
+        {
+            const TimedDof older = count > 1 ? m_Slots[(count - 2) % m_Capacity].Load() : newer;
+            if (older.time >= newer.time)
+            {
+                dof = newer.dof;
+                return true;
+            }
+            Interpolate(older, newer, newer.time + std::min(time - newer.time, m_MaxExtrapolation), dof);
+            return true;
+        }
+        // the slot following the latest one may be overwritten concurrently
+        for (size_t i = 2; i <= std::min(count, m_Capacity - 1); i++)
+        {
+            const TimedDof older = m_Slots[(count - i) % m_Capacity].Load();
+            if (older.time >= newer.time)
+            {
+                // writer has caught up
+                break;
+            }
+            if (older.time <= time)
+            {
+                Interpolate(older, newer, time, dof);
+                return true;
+            }
+            newer = older;
+        }
+        return false;
     }
 
-    BiQuadStabilizer::BiQuadFilter::BiQuadFilter(float frequency)
+    int64_t SampleHistory::GetLatestTime() const
     {
-        const double r = sin(M_PI_4);
-        const double a = tan(M_PI * frequency / m_SamplingFrequency);
-        const double aSquare = a * a;
-        const double s = (aSquare + 2.0 * a * r + 1.0);
-        m_A = aSquare / s;
-        m_D1 = 2.0 * (1.0 - aSquare) / s;
-        m_D2 = -(aSquare - 2.0 * a * r + 1.0) / s;
-        m_W0 = m_W1 = m_W2 = 0.0;
+        const size_t count = m_Count.load(std::memory_order_acquire);
+        return count > 0 ? m_Slots[(count - 1) % m_Capacity].Load().time : 0;
     }
 
-    double BiQuadStabilizer::BiQuadFilter::Filter(const double value)
+    void SampleHistory::Interpolate(const TimedDof& older, const TimedDof& newer, const int64_t time, Dof& dof)
     {
-        m_W0 = m_D1 * m_W1 + m_D2 * m_W2 + value;
-        return m_A * (std::exchange(m_W2, m_W1) + 2.0f * std::exchange(m_W1, m_W0) + m_W0);
+        const double factor =
+            static_cast<double>(time - older.time) / static_cast<double>(newer.time - older.time);
+        for (int value = sway; value <= pitch; value++)
+        {
+            const double from = older.dof.data[value];
+            const double delta = newer.dof.data[value] - from;
+            dof.data[value] = static_cast<float>(
+                value < yaw ? from + delta * factor : WrapAngle(from + WrapAngle(delta) * factor));
+        }
     }
-} // namespace filter
\ No newline at end of file
+} // namespace filter
@@ -3,113 +3,233 @@
 #pragma once
 
 #include <log.h>
+#include "biquad.h"
 
 namespace filter
 {
-    template <typename Value>
+    // common base of pose filters, derived filter type is resolved at compile time to avoid virtual dispatch
+    template <typename Value, typename Derived>
     class FilterBase
     {
       public:
         explicit FilterBase(const float strength, const std::string& type) : m_Type(type)
         {
-            FilterBase<Value>::SetStrength(strength);
+            FilterBase::SetStrength(strength);
         }
-        virtual ~FilterBase(){};
-        virtual float SetStrength(const float strength)
+        float SetStrength(const float strength)
         {
             const float limitedStrength = std::min(1.0f, std::max(0.0f, strength));
             openxr_api_layer::log::DebugLog("%s filter strength set: %f", m_Type.c_str(), limitedStrength);
             m_Strength = limitedStrength;
             return m_Strength;
         }
-        void Filter(Value& value)
+        void Filter(Value& value, XrTime time)
         {
             if (0.0f < m_Strength)
             {
-                ApplyFilter(value);
+                static_cast<Derived*>(this)->ApplyFilter(value, time);
             }
         }
-        virtual void ApplyFilter(Value& value) = 0;
-        virtual void Reset(const Value& value) = 0;
 
       protected:
+        ~FilterBase() = default;
+
         float m_Strength;
         std::string m_Type;
     };
 
-    // translational filters
-    class SingleEmaFilter : public FilterBase<XrVector3f>
+    // placeholder until filters are loaded from configuration
+    template <typename Value>
+    class NoFilter final
     {
       public:
-        explicit SingleEmaFilter(float strength);
-        float SetStrength(float strength) override;
-        void ApplyFilter(XrVector3f& location) override;
-        void Reset(const XrVector3f& location) override;
+        float SetStrength(float)
+        {
+            return 0.0f;
+        }
+        void Filter(Value&, XrTime) {}
+        void Reset(const Value&) {}
+    };
 
-      protected:
-        XrVector3f m_Alpha{1.0f - m_Strength, 1.0f - m_Strength, 1.0f - m_Strength};
-        XrVector3f m_OneMinusAlpha{m_Strength, m_Strength, m_Strength};
-        XrVector3f m_Ema{0, 0, 0};
-        [[nodiscard]] XrVector3f EmaFunction(XrVector3f current, XrVector3f stored) const;
+    // translational filters: exponential moving average with Order stages
+    template <int Order>
+    class EmaFilter final : public FilterBase<XrVector3f, EmaFilter<Order>>
+    {
+        static_assert(0 < Order && 4 > Order, "ema filter supports order 1 to 3");
+
+      public:
+        explicit EmaFilter(float strength);
+        float SetStrength(float strength);
+        void ApplyFilter(XrVector3f& location, XrTime time);
+        void Reset(const XrVector3f& location);
 
       private:
+        template <size_t... Stage>
+        void ApplyStages(XrVector3f& location, std::index_sequence<Stage...>);
+
+        // weights for combining the stages into lag compensated output (ema, 2 * ema - ema(ema), ...)
+        static constexpr float Weight(const int stage)
+        {
+            float binomial{1.0f};
+            for (int i = 0; i <= stage; i++)
+            {
+                binomial = binomial * static_cast<float>(Order - i) / static_cast<float>(i + 1);
+            }
+            return 0 == stage % 2 ? binomial : -binomial;
+        }
+
+        XrVector3f m_Alpha{1.0f - this->m_Strength, 1.0f - this->m_Strength, 1.0f - this->m_Strength};
+        XrVector3f m_OneMinusAlpha{this->m_Strength, this->m_Strength, this->m_Strength};
+        std::array<XrVector3f, Order> m_Stages{};
         float m_VerticalFactor{1.f};
     };
 
-    class DoubleEmaFilter : public SingleEmaFilter
+    template <int Order>
+    void EmaFilter<Order>::ApplyFilter(XrVector3f& location, XrTime)
     {
-      public:
-        explicit DoubleEmaFilter(const float strength) : SingleEmaFilter(strength){};
-        void ApplyFilter(XrVector3f& location) override;
-        void Reset(const XrVector3f& location) override;
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local,
+                               "EmaFilter::ApplyFilter",
+                               TLArg(Order, "Order"),
+                               TLArg(xr::ToString(location).c_str(), "location"),
+                               TLArg(xr::ToString(m_Alpha).c_str(), "m_Alpha"));
 
-      protected:
-        XrVector3f m_EmaEma{0, 0, 0};
-    };
+        ApplyStages(location, std::make_index_sequence<Order>{});
+
+        TraceLoggingWriteStop(local, "EmaFilter::ApplyFilter", TLArg(xr::ToString(location).c_str(), "location"));
+    }
 
-    class TripleEmaFilter : public DoubleEmaFilter
+    template <int Order>
+    template <size_t... Stage>
+    void EmaFilter<Order>::ApplyStages(XrVector3f& location, std::index_sequence<Stage...>)
     {
-      public:
-        explicit TripleEmaFilter(const float strength) : DoubleEmaFilter(strength){};
-        void ApplyFilter(XrVector3f& location) override;
-        void Reset(const XrVector3f& location) override;
+        static_assert((Weight(Stage) + ...) == 1.f, "stage weights have to keep a constant input unchanged");
+        XrVector3f input = location;
+        ((m_Stages[Stage] = m_Alpha * input + m_OneMinusAlpha * m_Stages[Stage], input = m_Stages[Stage]), ...);
+        location = XrVector3f{0, 0, 0};
+        ((location = location + XrVector3f{Weight(Stage), Weight(Stage), Weight(Stage)} * m_Stages[Stage]), ...);
+    }
+
+    template <int Order>
+    void EmaFilter<Order>::Reset(const XrVector3f& location)
+    {
+        m_Stages.fill(location);
+    }
 
-      protected:
-        XrVector3f m_EmaEmaEma{0, 0, 0};
-    };
+    using SingleEmaFilter = EmaFilter<1>;
+    using DoubleEmaFilter = EmaFilter<2>;
+    using TripleEmaFilter = EmaFilter<3>;
 
-    // rotational filters
-    class SingleSlerpFilter : public FilterBase<XrQuaternionf>
+    // rotational filters: cascaded slerp with Order stages
+    template <int Order>
+    class SlerpFilter final : public FilterBase<XrQuaternionf, SlerpFilter<Order>>
     {
+        static_assert(0 < Order && 4 > Order, "slerp filter supports order 1 to 3");
+
       public:
-        explicit SingleSlerpFilter(const float strength) : FilterBase(strength, "rotational"){};
-        void ApplyFilter(XrQuaternionf& rotation) override;
-        void Reset(const XrQuaternionf& rotation) override;
+        explicit SlerpFilter(const float strength) : FilterBase<XrQuaternionf, SlerpFilter>(strength, "rotational")
+        {
+            m_Stages.fill(xr::math::Quaternion::Identity());
+        }
+        void ApplyFilter(XrQuaternionf& rotation, XrTime time);
+        void Reset(const XrQuaternionf& rotation);
 
-      protected:
-        XrQuaternionf m_FirstStage = xr::math::Quaternion::Identity();
+      private:
+        template <size_t... Stage>
+        void ApplyStages(XrQuaternionf& rotation, std::index_sequence<Stage...>);
+
+        std::array<XrQuaternionf, Order> m_Stages{};
     };
 
-    class DoubleSlerpFilter : public SingleSlerpFilter
+    template <int Order>
+    void SlerpFilter<Order>::ApplyFilter(XrQuaternionf& rotation, XrTime)
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local,
+                               "SlerpFilter::ApplyFilter",
+                               TLArg(Order, "Order"),
+                               TLArg(xr::ToString(rotation).c_str(), "rotation"),
+                               TLArg(this->m_Strength, "m_Strength"));
+
+        ApplyStages(rotation, std::make_index_sequence<Order>{});
+
+        TraceLoggingWriteStop(local, "SlerpFilter::ApplyFilter", TLArg(xr::ToString(rotation).c_str(), "rotation"));
+    }
+
+    template <int Order>
+    template <size_t... Stage>
+    void SlerpFilter<Order>::ApplyStages(XrQuaternionf& rotation, std::index_sequence<Stage...>)
+    {
+        ((m_Stages[Stage] = xr::math::Quaternion::Slerp(rotation, m_Stages[Stage], this->m_Strength),
+          rotation = m_Stages[Stage]),
+         ...);
+    }
+
+    template <int Order>
+    void SlerpFilter<Order>::Reset(const XrQuaternionf& rotation)
+    {
+        m_Stages.fill(rotation);
+    }
+
+    using SingleSlerpFilter = SlerpFilter<1>;
+    using DoubleSlerpFilter = SlerpFilter<2>;
+    using TripleSlerpFilter = SlerpFilter<3>;
+
+    // speed adaptive filters: cutoff frequency rises with velocity to reduce lag on fast motion
+    class OneEuroTranslationFilter final : public FilterBase<XrVector3f, OneEuroTranslationFilter>
     {
       public:
-        explicit DoubleSlerpFilter(const float strength) : SingleSlerpFilter(strength){};
-        void ApplyFilter(XrQuaternionf& rotation) override;
-        void Reset(const XrQuaternionf& rotation) override;
+        explicit OneEuroTranslationFilter(float strength);
+        float SetStrength(float strength);
+        void ApplyFilter(XrVector3f& location, XrTime time);
+        void Reset(const XrVector3f& location);
 
-      protected:
-        XrQuaternionf m_SecondStage = xr::math::Quaternion::Identity();
+      private:
+        float m_VerticalFactor{1.f};
+        float m_Beta{0.f};
+        XrVector3f m_MinCutoff{};
+        XrVector3f m_Previous{0, 0, 0};
+        // unfiltered input of previous call, speed is derived from input instead of lagging output
+        XrVector3f m_PreviousInput{0, 0, 0};
+        float m_Speed{0.f};
+        XrTime m_LastTime{0};
     };
 
-    class TripleSlerpFilter : public DoubleSlerpFilter
+    class OneEuroRotationFilter final : public FilterBase<XrQuaternionf, OneEuroRotationFilter>
     {
       public:
-        explicit TripleSlerpFilter(const float strength) : DoubleSlerpFilter(strength){};
-        void ApplyFilter(XrQuaternionf& rotation) override;
-        void Reset(const XrQuaternionf& rotation) override;
+        explicit OneEuroRotationFilter(float strength);
+        float SetStrength(float strength);
+        void ApplyFilter(XrQuaternionf& rotation, XrTime time);
+        void Reset(const XrQuaternionf& rotation);
 
-      protected:
-        XrQuaternionf m_ThirdStage = xr::math::Quaternion::Identity();
+      private:
+        float m_Beta{0.f};
+        float m_MinCutoff{};
+        XrQuaternionf m_Previous = xr::math::Quaternion::Identity();
+        XrQuaternionf m_PreviousInput = xr::math::Quaternion::Identity();
+        float m_Speed{0.f};
+        XrTime m_LastTime{0};
+    };
+
+    // concrete filter types selectable by configuration, visited without virtual dispatch
+    using TranslationFilter = std::variant<NoFilter<XrVector3f>,
+                                           SingleEmaFilter,
+                                           DoubleEmaFilter,
+                                           TripleEmaFilter,
+                                           OneEuroTranslationFilter>;
+    using RotationFilter = std::variant<NoFilter<XrQuaternionf>,
+                                        SingleSlerpFilter,
+                                        DoubleSlerpFilter,
+                                        TripleSlerpFilter,
+                                        OneEuroRotationFilter>;
+
+    struct FrequencyResponse
+    {
+        float frequency{};  // Hz
+        float magnitude{};  // dB
+        float phase{};      // degree
+        float groupDelay{}; // milliseconds
     };
 
     class StabilizerBase
@@ -118,10 +238,17 @@ namespace filter
         virtual ~StabilizerBase() = default;
         virtual void SetStrength(float frequency) = 0;
         virtual void SetStartTime(int64_t now) = 0;
-        virtual void Insert(const utility::Dof& sample, int64_t now) = 0;
+        void Insert(const utility::Dof& sample, int64_t now)
+        {
+            const utility::TimedDof timed{sample, now};
+            InsertBatch({&timed, 1});
+        }
+        // samples in chronological order, filtered under a single lock and published once
+        virtual void InsertBatch(std::span<const utility::TimedDof> samples) = 0;
         virtual void Read(utility::Dof& dof) = 0;
 
       protected:
+        // serializes filter state updates, readers use the published sample instead
         std::mutex m_SampleMutex;
     };
 
@@ -130,74 +257,198 @@ namespace filter
       public:
         explicit PassThroughStabilizer(const std::vector<utility::DofValue>& relevant);
         ;
-        void SetStrength(float strength) override{};
-        void SetStartTime(int64_t now) override{};
-        void Insert(const utility::Dof& dof, int64_t now) override;
+        void SetStrength(float) override{};
+        void SetStartTime(int64_t) override{};
+        void InsertBatch(std::span<const utility::TimedDof> samples) override;
         void Read(utility::Dof& dof) override;
 
       protected:
+        void Publish();
+
         std::vector<utility::DofValue> m_Relevant;
         utility::Dof m_CurrentSample{};
         utility::Dof m_Factor{};
+
+      private:
+        utility::SeqLock<utility::Dof> m_Published{};
     };
 
     class LowPassStabilizer : public PassThroughStabilizer
     {
       public:
-        explicit LowPassStabilizer(const std::vector<utility::DofValue>& relevant);
+        // sampling rate (Hz) of the inserted samples, used for filter design and response evaluation
+        // cutoff scale is applied to the frequencies derived from strength
+        LowPassStabilizer(const std::vector<utility::DofValue>& relevant,
+                          double samplingRate,
+                          double cutoffScale = 1.0);
+        std::vector<FrequencyResponse> GetFrequencyResponse(utility::DofValue value,
+                                                            const std::vector<float>& frequencies);
+        // cutoff frequency (Hz) of a dof, 0 if held and -1 if unfiltered
+        [[nodiscard]] float GetCutoff(utility::DofValue value);
 
       protected:
         void SetFrequencies(float strength);
         bool Disabled(const utility::Dof& dof);
-
+        // numerator (b) and denominator (a) coefficients of transfer function in powers of z^-1
+        virtual void GetTransferFunction(float frequency, double (&b)[3], double (&a)[3]) const = 0;
+        [[nodiscard]] std::vector<FrequencyResponse> EvaluateResponse(utility::DofValue value,
+                                                                      const std::vector<float>& frequencies) const;
+        void WriteFrequencyResponse() const;
+
+        double m_SamplingRate;
+        double m_CutoffScale;
         bool m_Initialized{false};
         utility::Dof m_Frequency{};
 
       private:
         bool m_Disabled{false}, m_Blocking{false};
+        bool m_WriteResponse{false};
     };
 
     class EmaStabilizer : public LowPassStabilizer
     {
       public:
-        explicit EmaStabilizer(const std::vector<utility::DofValue>& relevant) : LowPassStabilizer(relevant){};
+        EmaStabilizer(const std::vector<utility::DofValue>& relevant, double samplingRate);
         void SetStrength(float strength) override;
         void SetStartTime(int64_t now) override;
-        void Insert(const utility::Dof& dof, int64_t now) override;
+        void InsertBatch(std::span<const utility::TimedDof> samples) override;
+
+      protected:
+        void GetTransferFunction(float frequency, double (&b)[3], double (&a)[3]) const override;
 
       private:
+        void InsertSample(const utility::Dof& dof, int64_t now);
+
         int64_t m_LastSampleTime{};
     };
 
     class BiQuadStabilizer : public LowPassStabilizer
     {
       public:
-        explicit BiQuadStabilizer(const std::vector<utility::DofValue>& relevant) : LowPassStabilizer(relevant){};
+        BiQuadStabilizer(const std::vector<utility::DofValue>& relevant, double samplingRate);
         void SetStrength(float strength) override;
         void SetStartTime(int64_t now) override;
-        void Insert(const utility::Dof& dof, int64_t now) override;
+        void InsertBatch(std::span<const utility::TimedDof> samples) override;
+
+      protected:
+        void GetTransferFunction(float frequency, double (&b)[3], double (&a)[3]) const override;
 
       private:
+        // strength was mapped to cutoffs for a design rate of 600 Hz while samples arrived at 1 kHz,
+        // scaling keeps the effective cutoffs of existing configurations
+        static constexpr double m_LegacyCutoffScale{1000.0 / 600.0};
+
+        void InsertSample(const utility::Dof& dof, int64_t now);
         void ResetFilters();
-        double Filter(float dofValue, utility::DofValue value) const;
+        void UpdateCoefficients(int64_t now);
 
-        class BiQuadFilter
+        // coefficients precomputed per cutoff frequency for quantized sampling intervals
+        class CoefficientCache
         {
           public:
-            BiQuadFilter(float frequency);
-            double Filter(double value);
+            static constexpr int64_t m_Resolution{25000}; // 25 microseconds
+            static constexpr size_t m_Intervals{400};      // up to 10 milliseconds
+
+            const BiQuadBank::Coefficients* GetTable(float frequency);
+            void Retain(const std::set<float>& frequencies);
+            static size_t ToIndex(int64_t interval);
 
           private:
-            float m_SamplingFrequency{600.f};
-
-            double m_A;
-            double m_D1;
-            double m_D2;
-            double m_W0;
-            double m_W1;
-            double m_W2;
+            std::map<float, std::vector<BiQuadBank::Coefficients>> m_Tables{};
+        };
+
+        BiQuadBank m_Bank{};
+        bool m_AdaptiveRate{false};
+        int64_t m_LastSampleTime{};
+        IntervalAverage m_Interval{};
+        CoefficientCache m_CoefficientCache{};
+        const BiQuadBank::Coefficients* m_Table[6]{};
+        bool m_Rotational{false};
+        // orientation the filtered rotation vector is relative to (w, x, y, z)
+        double m_Anchor[4]{1.0, 0.0, 0.0, 0.0};
+    };
+
+    // constant acceleration kalman filter per dof, extrapolates stabilized values to the requested (display) time
+    class KalmanPredictor
+    {
+      public:
+        KalmanPredictor(const std::vector<utility::DofValue>& relevant, int64_t maxHorizon);
+        void Reset();
+        void Update(const utility::Dof& dof, int64_t now);
+        void Predict(utility::Dof& dof, int64_t time) const;
+
+      private:
+        struct State
+        {
+            double x[3]{}; // position, velocity, acceleration
+            double p[3][3]{};
+        };
+
+        struct Estimate
+        {
+            float position[6]{};
+            float velocity[6]{};
+            float acceleration[6]{};
+            int64_t time{0};
         };
 
-        std::unique_ptr<BiQuadFilter> m_Filter[9]{};
+        std::vector<utility::DofValue> m_Relevant;
+        State m_States[6]{};
+        int64_t m_LastTime{0};
+        int64_t m_MaxHorizon{0};
+        utility::SeqLock<Estimate> m_Published{};
+    };
+
+    // anti-aliasing low pass (windowed sinc) for oversampled input, evaluated only for every factor-th sample
+    class Decimator
+    {
+      public:
+        explicit Decimator(int factor);
+        void Reset();
+        bool Push(const utility::TimedDof& sample, utility::TimedDof& output);
+
+      private:
+        // dofs padded to a multiple of the vector width
+        static constexpr size_t m_Channels{8};
+        static constexpr size_t m_TapsPerPhase{6};
+
+        void Convolve(const double* window, double (&sum)[m_Channels]) const;
+
+        size_t m_Factor;
+        size_t m_Taps;
+        std::vector<double> m_Coefficients{};
+        // history of input samples, stored twice to keep every window contiguous
+        std::vector<double> m_History{};
+        size_t m_Position{0};
+        size_t m_Phase{0};
+        bool m_Initialized{false};
+        // continuous angles to avoid jump from -180 to 180 degrees within filter window
+        double m_LastAngle[3]{};
+        double m_Unwrapped[3]{};
+    };
+
+    // timestamped stabilized values for reading at an exact point in time
+    // single writer, multiple readers
+    class SampleHistory
+    {
+      public:
+        void Reset();
+        void SetMaxExtrapolation(int64_t duration);
+        void Store(const utility::TimedDof& sample);
+        // interpolate to requested time, extrapolation beyond latest sample is limited to m_MaxExtrapolation
+        bool Get(int64_t time, utility::Dof& dof) const;
+        [[nodiscard]] int64_t GetLatestTime() const;
+
+      private:
+        static constexpr size_t m_Capacity{64};
+
+        static void Interpolate(const utility::TimedDof& older,
+                                const utility::TimedDof& newer,
+                                int64_t time,
+                                utility::Dof& dof);
+
+        std::array<utility::SeqLock<utility::TimedDof>, m_Capacity> m_Slots{};
+        std::atomic_size_t m_Count{0};
+        int64_t m_MaxExtrapolation{0};
     };
 } // namespace filter
\ No newline at end of file
@@ -74,6 +74,13 @@ namespace openxr_api_layer {
                 XR_HTCX_VIVE_TRACKER_INTERACTION_EXTENSION_NAME,
                 type.c_str());
         }
+
+        // request extension to put sampled tracker input on the runtime clock
+        if (std::ranges::find(implicitExtensions, XR_KHR_WIN32_CONVERT_PERFORMANCE_COUNTER_TIME_EXTENSION_NAME) ==
+            implicitExtensions.cend())
+        {
+            implicitExtensions.push_back(XR_KHR_WIN32_CONVERT_PERFORMANCE_COUNTER_TIME_EXTENSION_NAME);
+        }
  
         // Only request implicit extensions that are supported.
         //
@@ -41,8 +41,9 @@ requested_functions = [
     "xrGetInputSourceLocalizedName",
     "xrDestroyAction",
     "xrDestroyActionSet",
-    "xrDestroySpace"
+    "xrDestroySpace",
+    "xrConvertWin32PerformanceCounterToTimeKHR"
 ]
 
 # The list of OpenXR extensions our layer will either override or use.
-extensions = []
+extensions = ["XR_KHR_win32_convert_performance_counter_time"]
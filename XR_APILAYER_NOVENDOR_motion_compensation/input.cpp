@@ -444,6 +444,8 @@ namespace input
         if ((m_Keyboard.GetKeyState(Cfg::KeyLogTracker, isRepeat) && !isRepeat) || m_Mmf->GetTrigger(ActivityBit::LogTracker))
         {
             m_Layer->m_Tracker->LogCurrentTrackerPoses(m_Layer->m_Session, time, m_Layer->m_Activated);
+            m_Layer->m_DeltaCache.LogStatistics();
+            m_Layer->m_EyeCache.LogStatistics();
         }
 
         m_Mmf->WriteConfirm();
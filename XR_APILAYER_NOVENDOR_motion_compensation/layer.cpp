@@ -26,6 +26,7 @@
 #include "tracker.h"
 #include "output.h"
 #include "config.h"
+#include "worker.h"
 #include <log.h>
 #include <util.h>
 
@@ -46,6 +47,8 @@ namespace openxr_api_layer
         }
         m_Overlay.reset();
         m_Tracker.reset();
+        // sampling has been stopped along with the tracker
+        worker::GetRuntime()->Shutdown();
 
         const XrResult result = OpenXrApi::xrDestroyInstance(instance);
 
@@ -133,6 +136,11 @@ namespace openxr_api_layer
             return result;
         }
 
+        worker::GetRuntime()->Configure();
+
+        m_CounterConversion = IsExtensionGranted(XR_KHR_WIN32_CONVERT_PERFORMANCE_COUNTER_TIME_EXTENSION_NAME);
+        Log("conversion of performance counter to xr time is %s", m_CounterConversion ? "available" : "unavailable");
+
         m_Tracker = tracker::GetTracker();
         m_Input = std::make_shared<input::InputHandler>(input::InputHandler(this));
 
@@ -232,6 +240,12 @@ namespace openxr_api_layer
         m_DeltaCache.SetTolerance(toleranceTime);
         m_EyeCache.SetTolerance(toleranceTime);
 
+        bool cacheInterpolate{false};
+        GetConfig()->GetBool(Cfg::CacheInterpolate, cacheInterpolate);
+        Log("cache lookup %s", cacheInterpolate ? "interpolates between samples" : "uses nearest sample");
+        m_DeltaCache.SetInterpolation(cacheInterpolate);
+        m_EyeCache.SetInterpolation(cacheInterpolate);
+
         // initialize keyboard input handler
         if (!m_Input->Init())
         {
@@ -503,6 +517,11 @@ namespace openxr_api_layer
 
         m_Tracker->InvalidateCalibration(true);
 
+        m_DeltaCache.LogStatistics();
+        m_DeltaCache.ResetStatistics();
+        m_EyeCache.LogStatistics();
+        m_EyeCache.ResetStatistics();
+
         // clean up open xr session resources
         DestroyTrackerActions("xrDestroySession");
 
@@ -1136,6 +1155,7 @@ namespace openxr_api_layer
         const XrSpace refSpace = viewLocateInfo->space;
 
         DebugLog("xrLocateViews(%lld): reference space = %llu", displayTime, refSpace);
+        m_Tracker->NotifyLocateViews();
         TraceLoggingWriteTagged(local,
                                 "OpenXrLayer::xrLocateViews",
                                 TLArg(xr::ToCString(viewLocateInfo->viewConfigurationType), "ViewConfigurationType"),
@@ -1173,10 +1193,11 @@ namespace openxr_api_layer
             std::lock_guard lock(m_FrameLock);
 
             // store eye poses to avoid recalculation in xrEndFrame
-            std::vector<XrPosef> originalEyePoses{};
-            for (uint32_t i = 0; i < *viewCountOutput; i++)
+            utility::EyePoses originalEyePoses{};
+            originalEyePoses.count = std::min(*viewCountOutput, utility::EyePoses::m_MaxViews);
+            for (uint32_t i = 0; i < originalEyePoses.count; i++)
             {
-                originalEyePoses.push_back(views[i].pose);
+                originalEyePoses.poses[i] = views[i].pose;
             }
 
             if (isViewSpace(refSpace))
@@ -1386,7 +1407,9 @@ namespace openxr_api_layer
         const XrResult result = OpenXrApi::xrWaitFrame(session, frameWaitInfo, frameState);
         if (XR_SUCCEEDED(result))
         {
-            m_Tracker->SetFrameTime(frameState->predictedDisplayTime);
+            m_Tracker->SetFrameTime(frameState->predictedDisplayTime, frameState->predictedDisplayPeriod);
+            m_DeltaCache.SetFramePeriod(frameState->predictedDisplayPeriod);
+            m_EyeCache.SetFramePeriod(frameState->predictedDisplayPeriod);
         }
 
         DebugLog("xrWaitFrame predicted time: %lld, predicted period: %lld",
@@ -1473,12 +1496,12 @@ namespace openxr_api_layer
         XrFrameEndInfo chainFrameEndInfo = *frameEndInfo;
 
         XrPosef delta{Pose::Identity()};
-        std::vector<XrPosef> cachedEyePoses;
+        utility::EyePoses cachedEyePoses{};
         if (m_Activated)
         {
             delta = m_DeltaCache.GetSample(time);
             m_DeltaCache.CleanUp(time);
-            cachedEyePoses = m_UseEyeCache ? m_EyeCache.GetSample(time) : std::vector<XrPosef>();
+            cachedEyePoses = m_UseEyeCache ? m_EyeCache.GetSample(time) : utility::EyePoses{};
             m_EyeCache.CleanUp(time);
         }
         else if (m_Tracker->m_Calibrated && (m_RecorderActive || (m_Overlay && m_Overlay->m_MarkersActive)))
@@ -1582,8 +1605,8 @@ namespace openxr_api_layer
                         TLArg(xr::ToString((*projectionViews)[j].fov).c_str(), "Fov"));
 
                     XrPosef revertedEyePose =
-                        m_UseEyeCache
-                            ? cachedEyePoses[j]
+                        m_UseEyeCache && j < cachedEyePoses.count
+                            ? cachedEyePoses.poses[j]
                             : xr::Normalize(Pose::Multiply(
                                   (*projectionViews)[j].pose,
                                   Pose::Invert(Pose::Multiply(Pose::Multiply(stageToRef, delta), refToStage))));
@@ -2166,6 +2189,23 @@ namespace openxr_api_layer
         return location.pose;
     }
 
+    std::optional<XrTime> OpenXrLayer::ConvertPerformanceCounter(const LARGE_INTEGER& counter)
+    {
+        if (!m_CounterConversion)
+        {
+            return {};
+        }
+        XrTime time;
+        if (const XrResult result = xrConvertWin32PerformanceCounterToTimeKHR(GetXrInstance(), &counter, &time);
+            XR_FAILED(result))
+        {
+            ErrorLog("%s: unable to convert performance counter: %s", __FUNCTION__, xr::ToCString(result));
+            m_CounterConversion = false;
+            return {};
+        }
+        return time;
+    }
+
     std::optional<XrPosef> OpenXrLayer::GetCalibratedHmdPose() const
     {
         return m_CalibratedHmdPose;
@@ -110,6 +110,7 @@ namespace openxr_api_layer
         std::shared_ptr<graphics::ICompositionFrameworkFactory> GetCompositionFactory();
         bool SyncActions(const std::string& caller);
         std::optional<XrPosef> GetCurrentPosition(XrTime time, bool tracker);
+        std::optional<XrTime> ConvertPerformanceCounter(const LARGE_INTEGER& counter);
         std::optional<XrPosef> GetCalibratedHmdPose() const;
         void ResetCalibratedHmdPose();
         void SetCor(const XrPosef& pose) const;
@@ -182,6 +183,7 @@ namespace openxr_api_layer
         bool m_RecorderActive{false};
         bool m_VarjoPollWorkaround{false};
         bool m_SyncActionHint{false};
+        bool m_CounterConversion{false};
         XrTime m_LastFrameTime{0};
         XrTime m_UpdateRefSpaceTime{0};
         XrTime m_LastSessionTransition{0};
@@ -201,11 +203,12 @@ namespace openxr_api_layer
         tracker::ViveTrackerInfo m_ViveTracker;
         input::InteractionPaths m_InteractionPaths;
         utility::Cache<XrPosef> m_DeltaCache{"delta", xr::math::Pose::Identity()};
-        utility::Cache<std::vector<XrPosef>> m_EyeCache{"eyes",
-                                                        std::vector<XrPosef>{xr::math::Pose::Identity(),
-                                                                             xr::math::Pose::Identity(),
-                                                                             xr::math::Pose::Identity(),
-                                                                             xr::math::Pose::Identity()}};
+        utility::Cache<utility::EyePoses> m_EyeCache{"eyes",
+                                                     utility::EyePoses{{xr::math::Pose::Identity(),
+                                                                        xr::math::Pose::Identity(),
+                                                                        xr::math::Pose::Identity(),
+                                                                        xr::math::Pose::Identity()},
+                                                                       utility::EyePoses::m_MaxViews}};
         std::mutex m_FrameLock;
         std::unique_ptr<tracker::TrackerBase> m_Tracker{};
         std::unique_ptr<graphics::Overlay> m_Overlay{};
@@ -95,24 +95,6 @@ namespace output
 
         auto now = time_point_cast<milliseconds>(system_clock::now()).time_since_epoch().count();
 
-        // check communication thread;
-        if (m_MmfError)
-        {
-            StopThread();
-            if (!m_LastError)
-            {
-                m_LastError = now;
-            }
-            else if (now - m_LastError > 1000)
-            {
-                // retry starting thread after a second
-                m_LastError = 0;
-                m_MmfError = false;
-                m_StopThread = false;
-                m_Thread = new std::thread(&QueuedMmf::UpdateMmf, this);
-            }
-        }
-
         // queue up event
         std::lock_guard lock(m_QueueMutex);
         m_EventQueue.push_back({event, now});
@@ -122,12 +104,9 @@ namespace output
 
     bool EventMmf::WriteImpl(Mmf& mmf)
     {
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-
         EventData info;
         if (!mmf.Read(&info, sizeof(info), 0))
         {
-            m_MmfError.store(true);
             return false;
         }
         if (info.id)
@@ -147,7 +126,6 @@ namespace output
         info.eventTime = m_EventQueue.front().second;
         if (!mmf.Write(&info, sizeof(info)))
         {
-            m_MmfError.store(true);
             return false;
         }
         m_EventQueue.pop_front();
@@ -167,34 +145,12 @@ namespace output
 
     void PoseMmf::Transmit(const XrPosef& position, int poseType)
     {
-        using namespace std::chrono;
-
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local,
                                "PoseMmf::Transmit",
                                TLArg(xr::ToString(position).c_str(), "Dof"),
                                TLArg(poseType, "PoseType"));
 
-        auto now = time_point_cast<milliseconds>(system_clock::now()).time_since_epoch().count();
-
-        // check communication thread;
-        if (m_MmfError)
-        {
-            StopThread();
-            if (!m_LastError)
-            {
-                m_LastError = now;
-            }
-            else if (now - m_LastError > 1000)
-            {
-                DebugLog("PoseMmf::Transmit: retry starting thread");
-                m_LastError = 0;
-                m_MmfError = false;
-                m_StopThread = false;
-                m_Thread = new std::thread(&QueuedMmf::UpdateMmf, this);
-            }
-        }
-      
         // queue up event
         if (poseType > 0)
         {
@@ -220,12 +176,9 @@ namespace output
 
     bool PoseMmf::WriteImpl(Mmf& mmf)
     {
-        std::this_thread::sleep_for(std::chrono::milliseconds(3));
-
         std::pair<XrPosef, int32_t> data;
         if (!mmf.Read(&data, sizeof(data), 0))
         {
-            m_MmfError.store(true);
             return false;
         }
         if (data.second > 0)
@@ -245,7 +198,6 @@ namespace output
                  xr::ToString(m_EventQueue.front().first).c_str());   
         if (!mmf.Write(&m_EventQueue.front(), sizeof(data)))
         {
-            m_MmfError.store(true);
             return false;
         }
         m_EventQueue.pop_front();
@@ -507,6 +459,12 @@ namespace output
         {
             return;
         }
+        const std::chrono::nanoseconds now = std::chrono::steady_clock::now().time_since_epoch();
+        WritePoses(now.count(), newLine);
+    }
+
+    void PoseRecorder::WritePoses(const int64_t now, const bool newLine)
+    {
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local, "PoseRecorder::Write", TLArg(newLine, "NewLine"));
 
@@ -524,9 +482,8 @@ namespace output
             const XrVector3f& fO = m_Poses[Filtered].second;
             const XrVector3f& mO = m_Poses[Modified].second;
 
-            const std::chrono::nanoseconds now = std::chrono::steady_clock::now().time_since_epoch();
-            const float elapsed = ((now.count() - m_StartTime) / 1000) / 1000.f;
-            m_FileStream << elapsed << ";" << now.count() << ";" << m_FrameTime << ";"
+            const float elapsed = ((now - m_StartTime) / 1000) / 1000.f;
+            m_FileStream << elapsed << ";" << now << ";" << m_FrameTime << ";"
                 << iP.x * 1000.f << ";" << fP.x * 1000.f << ";" << mP.x * 1000.f << ";" 
                 << iP.z * 1000.f << ";" << fP.z * 1000.f << ";" << mP.z * 1000.f << ";" 
                 << iP.y * 1000.f << ";" << fP.y * 1000.f << ";" << mP.y * 1000.f << ";"
@@ -624,17 +581,16 @@ namespace output
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local, "PoseAndDofRecorder::AddDofValues", TLArg(static_cast<uint32_t>(type), "Type"));
 
-        std::lock_guard lock{m_RecorderMutex};
         switch (type)
         {
         case Sampled:
-            m_DofValues.sampled = dof;
+            m_Sampled.Store(dof);
             break;
         case Read:
-            m_DofValues.read = dof;
+            m_Read.Store(dof);
             break;
         case Momentary:
-            m_DofValues.momentary = dof;
+            m_Momentary.Store(dof);
             break;
         default:
             break;
@@ -643,6 +599,11 @@ namespace output
         TraceLoggingWriteStop(local, "PoseAndDofRecorder::AddDofValues", TLArg(true, "Success"));
     }
 
+    DofSample PoseAndDofRecorder::GetDofValues() const
+    {
+        return {m_Sampled.Load(), m_Read.Load(), m_Momentary.Load()};
+    }
+
     void PoseAndDofRecorder::Write(bool sampled, bool newLine)
     {
         if (!m_Started.load() || !m_PoseRecorded.load() || (m_Sampling.load() && m_RecordSamples && !sampled))
@@ -656,15 +617,8 @@ namespace output
         if (m_FileStream.is_open())
         {
             PoseRecorder::Write(sampled, false);
-            m_FileStream << ";" << m_DofValues.sampled.data[sway] << ";" << m_DofValues.read.data[sway] << ";"
-                         << m_DofValues.momentary.data[sway] << ";" << m_DofValues.sampled.data[surge] << ";"
-                         << m_DofValues.read.data[surge] << ";" << m_DofValues.momentary.data[surge] << ";"
-                         << m_DofValues.sampled.data[heave] << ";" << m_DofValues.read.data[heave] << ";"
-                         << m_DofValues.momentary.data[heave] << ";" << m_DofValues.sampled.data[yaw] << ";"
-                         << m_DofValues.read.data[yaw] << ";" << m_DofValues.momentary.data[yaw] << ";"
-                         << m_DofValues.sampled.data[roll] << ";" << m_DofValues.read.data[roll] << ";"
-                         << m_DofValues.momentary.data[roll] << ";" << m_DofValues.sampled.data[pitch] << ";"
-                         << m_DofValues.read.data[pitch] << ";" << m_DofValues.momentary.data[pitch];
+            // frame based lines have no sample time
+            WriteDofValues(GetDofValues(), std::nullopt);
             if (newLine)
             {
                 m_FileStream << "\n";
@@ -676,4 +630,43 @@ namespace output
         }
         TraceLoggingWriteStop(local, "PoseAndDofRecorder::Write", TLArg(false, "Stream_Open"));
     }
-} // namespace output
\ No newline at end of file
+
+    void PoseAndDofRecorder::WriteSample(const SampleRecord& record)
+    {
+        if (!m_Started.load() || !m_PoseRecorded.load())
+        {
+            return;
+        }
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "PoseAndDofRecorder::WriteSample", TLArg(record.time, "Time"));
+
+        std::lock_guard lock{m_RecorderMutex};
+        if (m_FileStream.is_open())
+        {
+            // use time of sampling instead of time of writing
+            WritePoses(record.captured, false);
+            WriteDofValues(record.values, record.time);
+            m_FileStream << "\n";
+            m_FileStream.flush();
+
+            TraceLoggingWriteStop(local, "PoseAndDofRecorder::WriteSample", TLArg(true, "Success"));
+            return;
+        }
+        TraceLoggingWriteStop(local, "PoseAndDofRecorder::WriteSample", TLArg(false, "Stream_Open"));
+    }
+
+    void PoseAndDofRecorder::WriteDofValues(const DofSample& values, const std::optional<XrTime> time)
+    {
+        const auto& [sampled, read, momentary] = values;
+        m_FileStream << ";" << sampled.data[sway] << ";" << read.data[sway] << ";" << momentary.data[sway] << ";"
+                     << sampled.data[surge] << ";" << read.data[surge] << ";" << momentary.data[surge] << ";"
+                     << sampled.data[heave] << ";" << read.data[heave] << ";" << momentary.data[heave] << ";"
+                     << sampled.data[yaw] << ";" << read.data[yaw] << ";" << momentary.data[yaw] << ";"
+                     << sampled.data[roll] << ";" << read.data[roll] << ";" << momentary.data[roll] << ";"
+                     << sampled.data[pitch] << ";" << read.data[pitch] << ";" << momentary.data[pitch] << ";";
+        if (time)
+        {
+            m_FileStream << *time;
+        }
+    }
+} // namespace output
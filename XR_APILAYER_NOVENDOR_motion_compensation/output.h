@@ -2,6 +2,7 @@
 
 #pragma once
 #include "resource.h"
+#include "worker.h"
 #include <log.h>
 
 // include definitions shared with c#
@@ -78,78 +79,93 @@ namespace output
     class QueuedMmf
     {
       public:
-        explicit QueuedMmf(std::string name) : m_MmfName(std::move(name))
-        {
-            m_Thread = new std::thread(&QueuedMmf::UpdateMmf, this);
-        }
+        explicit QueuedMmf(std::string name) : m_MmfName(std::move(name)) {}
 
         virtual ~QueuedMmf()
         {
             TraceLocalActivity(local);
             TraceLoggingWriteStart(local, "QueuedMmf::Destroy", TLArg(m_MmfName.c_str(), "MmfName"));
 
-            StopThread();
+            StopTask();
 
             TraceLoggingWriteStop(local, "QueuedMmf::Destroy", TLArg(m_MmfName.c_str(), "MmfName"));
         }
-      
-        void UpdateMmf()
-        {
-            Element element;
-            utility::Mmf mmf;
-            mmf.SetWriteable(sizeof(element));
-            mmf.SetName(m_MmfName);
 
-            if (!mmf.Write(&element, sizeof(element)))
-            {
-                m_MmfError.store(true);
-                return;
-            }
+      protected:
+        // to be called by derived classes once they are (still) fully constructed
+        void StartTask(const std::chrono::milliseconds interval)
+        {
+            m_Task = worker::GetRuntime()->Schedule(m_MmfName, interval, [this] { return UpdateMmf(); });
+        }
 
-            while (!m_StopThread.load())
+        void StopTask()
+        {
+            if (m_Task)
             {
-                if (!WriteImpl(mmf))
-                {
-                    break;
-                }
+                worker::GetRuntime()->Cancel(m_Task);
+                m_Task = 0;
             }
-            m_StopThread.store(true);
         }
 
-      protected:
-        void StopThread()
+        std::string m_MmfName;
+        std::deque<Element> m_EventQueue;
+        std::mutex m_QueueMutex;
+
+      private:
+        // executed periodically on background worker thread
+        bool UpdateMmf()
         {
-            m_StopThread.store(true);
-            if (m_Thread)
+            using namespace std::chrono;
+
+            if (m_MmfError)
             {
-                if (m_Thread->joinable())
+                if (steady_clock::now() - m_LastError < seconds(1))
                 {
-                    m_Thread->join();
+                    return true;
                 }
-                delete m_Thread;
-                m_Thread = nullptr;
+                // retry after a second
+                m_MmfError = false;
+            }
+            if (!m_Connected)
+            {
+                Element element{};
+                m_Mmf.SetWriteable(sizeof(element));
+                m_Mmf.SetName(m_MmfName);
+                m_Connected = m_Mmf.Write(&element, sizeof(element));
+            }
+            if (!m_Connected || !WriteImpl(m_Mmf))
+            {
                 TraceLoggingWrite(openxr_api_layer::log::g_traceProvider,
-                                  "EventMmf::StopThread",
+                                  "QueuedMmf::UpdateMmf",
                                   TLArg(m_MmfName.c_str(), "MmfName"),
-                                  TLArg(true, "Stopped"));
+                                  TLArg(false, "Success"));
+                m_Mmf.Close();
+                m_Connected = false;
+                m_MmfError = true;
+                m_LastError = steady_clock::now();
             }
+            return true;
         }
 
-        std::string m_MmfName;
-        std::thread* m_Thread{nullptr};
-        std::atomic_bool m_StopThread{false}, m_MmfError{false};
-        int64_t m_LastError{0};
-        std::deque<Element> m_EventQueue;
-        std::mutex m_QueueMutex;
-
-      private:
         virtual bool WriteImpl(utility::Mmf& mmf) = 0;
+
+        worker::TaskId m_Task{0};
+        utility::Mmf m_Mmf;
+        bool m_Connected{false}, m_MmfError{false};
+        std::chrono::steady_clock::time_point m_LastError{};
     };
 
     class EventMmf : public QueuedMmf < std::pair<Event, int64_t>>
     {
       public:
-        EventMmf() : QueuedMmf("Local\\OXRMC_Events") {};
+        EventMmf() : QueuedMmf("Local\\OXRMC_Events")
+        {
+            StartTask(std::chrono::milliseconds(10));
+        }
+        ~EventMmf() override
+        {
+            StopTask();
+        }
         void Execute(Event event);
 
     private:
@@ -163,7 +179,6 @@ namespace output
             Event::ModifierOn,    Event::ModifierOff,   Event::CalibrationLost, Event::VerboseOn,
             Event::VerboseOff,    Event::RecorderOn,    Event::RecorderOff,     Event::StabilizerOn,
             Event::StabilizerOff, Event::PassthroughOn, Event::PassthroughOff};
-        int64_t m_LastError{0};
     };
 
     // Singleton accessor.
@@ -172,14 +187,19 @@ namespace output
     class PoseMmf : public QueuedMmf<std::pair<XrPosef, int32_t>>
     {
       public:
-        PoseMmf() : QueuedMmf("Local\\OXRMC_PositionOutput") {};
+        PoseMmf() : QueuedMmf("Local\\OXRMC_PositionOutput")
+        {
+            StartTask(std::chrono::milliseconds(3));
+        }
+        ~PoseMmf() override
+        {
+            StopTask();
+        }
         void Transmit(const XrPosef& position, int poseType);
         void Reset();
 
       private: 
         bool WriteImpl(utility::Mmf& mmf) override;
-
-        int64_t m_LastError{0};
     };  
 
     class StatusMmf
@@ -233,6 +253,15 @@ namespace output
         utility::Dof momentary{};
     };
 
+    // sampled value together with read and momentary values current at sampling time
+    struct SampleRecord
+    {
+        DofSample values{};
+        XrTime time{0};
+        // steady clock time of sampling cycle
+        int64_t captured{0};
+    };
+
     class RecorderBase
     {
       public:
@@ -243,7 +272,9 @@ namespace output
         virtual void AddFrameTime(XrTime time) = 0;
         virtual void AddPose(const XrPosef& pose, RecorderPoseInput type) = 0;
         virtual void AddDofValues(const utility::Dof& dofValues, RecorderDofInput type) = 0;
+        [[nodiscard]] virtual DofSample GetDofValues() const = 0;
         virtual void Write(bool sampled = false, bool newLine = true) = 0;
+        virtual void WriteSample(const SampleRecord& record) = 0;
 
         std::atomic_bool m_Sampling{false};
     };
@@ -256,7 +287,12 @@ namespace output
         void AddFrameTime(XrTime time) override{};
         void AddPose(const XrPosef& pose, RecorderPoseInput type) override{};
         void AddDofValues(const utility::Dof& dofValues, RecorderDofInput type) override{};
+        [[nodiscard]] DofSample GetDofValues() const override
+        {
+            return {};
+        };
         void Write(bool sampled, bool newLine) override{};
+        void WriteSample(const SampleRecord& record) override{};
     };
 
     class PoseRecorder : public RecorderBase
@@ -269,9 +305,16 @@ namespace output
         void AddFrameTime(XrTime time) override;
         void AddPose(const XrPosef& pose, RecorderPoseInput type) override;
         void AddDofValues(const utility::Dof& dofValues, RecorderDofInput type) override{};
+        [[nodiscard]] DofSample GetDofValues() const override
+        {
+            return {};
+        };
         void Write(bool sampled, bool newLine) override;
+        void WriteSample(const SampleRecord& record) override{};
 
       protected:
+        void WritePoses(int64_t now, bool newLine);
+
         std::atomic_bool m_Started{false}, m_PoseRecorded{false};
         bool m_RecordSamples{false};
 
@@ -304,12 +347,18 @@ namespace output
         {
             m_HeadLine += "; Sway_Sampled; Sway_Read; Sway_Momentary; Surge_Sampled; Surge_Read; Surge_Momentary; "
                           "Heave_Sampled; Heave_Read; Heave_Momentary; Yaw_Sampled; Yaw_Read; Yaw_Momentary; "
-                          "Roll_Sampled; Roll_Read; Roll_Momentary; Pitch_Sampled; Pitch_Read; Pitch_Momentary";
+                          "Roll_Sampled; Roll_Read; Roll_Momentary; Pitch_Sampled; Pitch_Read; Pitch_Momentary; "
+                          "SampleTime";
         }
         void AddDofValues(const utility::Dof& dof, RecorderDofInput type) override;
+        [[nodiscard]] DofSample GetDofValues() const override;
         void Write(bool sampled = false, bool newLine = true) override;
+        void WriteSample(const SampleRecord& record) override;
 
       private:
-        DofSample m_DofValues{};
+        void WriteDofValues(const DofSample& values, std::optional<XrTime> time);
+
+        // accessed by sampling thread without taking the recorder mutex
+        utility::SeqLock<utility::Dof> m_Sampled{}, m_Read{}, m_Momentary{};
     };
 } // namespace output
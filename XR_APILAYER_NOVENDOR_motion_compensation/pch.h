@@ -25,6 +25,7 @@
 // Standard library.
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstdarg>
 #include <ctime>
 #include <iomanip>
@@ -35,12 +36,18 @@
 #include <string>
 #include <memory>
 #include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <functional>
 #include <vector>
 #include <set>
 #include <map>
 #include <deque>
 #include <cmath>
 #include <complex>
+#include <variant>
+#include <span>
+#include <bit>
 
 // Windows header files.
 #define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
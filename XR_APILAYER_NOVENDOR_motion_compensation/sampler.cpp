@@ -13,16 +13,208 @@ using namespace log;
 using namespace output;
 using namespace utility;
 
+namespace
+{
+    // combined kernel and user time of the calling thread in 100 ns units
+    int64_t GetThreadCpuTime()
+    {
+        FILETIME creation, exit, kernel, user;
+        if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+        {
+            return 0;
+        }
+        return static_cast<int64_t>((static_cast<uint64_t>(kernel.dwHighDateTime) << 32 | kernel.dwLowDateTime) +
+                                    (static_cast<uint64_t>(user.dwHighDateTime) << 32 | user.dwLowDateTime));
+    }
+
+    // cpu time in 100 ns units relative to elapsed wall time in percent
+    double CpuLoad(const int64_t cpuTime, const std::chrono::steady_clock::duration elapsed)
+    {
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        return seconds > 0.0 ? static_cast<double>(cpuTime) / 1e7 / seconds * 100.0 : 0.0;
+    }
+} // namespace
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
 namespace sampler
 {
+    std::string Telemetry::ToString() const
+    {
+        std::stringstream stream;
+        stream << "sampling rate = " << samplingRate << " Hz, cpu load = " << std::fixed << std::setprecision(2)
+               << cpuLoad << " %, cycles = " << cycles << ", overruns = " << overruns
+               << ", read failures = " << readFailures << ", dropped records = " << recordDropped
+               << ", late reads = " << lateReads << "; jitter: " << jitter.ToString()
+               << "; lock held: " << lockHeld.ToString() << "; sample age: " << sampleAge.ToString();
+        return stream.str();
+    }
+
+    TelemetryPage Telemetry::ToPage() const
+    {
+        return {samplingRate,
+                cpuLoad,
+                cycles,
+                overruns,
+                readFailures,
+                recordDropped,
+                lateReads,
+                jitter.mean,
+                jitter.maximum,
+                lockHeld.mean,
+                lockHeld.maximum,
+                sampleAge.mean,
+                sampleAge.maximum};
+    }
+
+    void SleepScheduler::WaitUntil(const std::chrono::steady_clock::time_point deadline)
+    {
+        std::this_thread::sleep_until(deadline);
+    }
+
+    void HybridScheduler::WaitUntil(const std::chrono::steady_clock::time_point deadline)
+    {
+        using namespace std::chrono;
+
+        // sleep granularity is too coarse for precise wake-up: sleep most of the time and yield the rest
+        if (const auto coarse = deadline - m_Spin; steady_clock::now() < coarse)
+        {
+            std::this_thread::sleep_until(coarse);
+        }
+        while (steady_clock::now() < deadline)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    TimerScheduler::TimerScheduler()
+    {
+        // available since windows 10, version 1803
+        m_Timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (!m_Timer)
+        {
+            ErrorLog("%s: unable to create high resolution timer: %d", __FUNCTION__, GetLastError());
+        }
+    }
+
+    TimerScheduler::~TimerScheduler()
+    {
+        if (m_Timer)
+        {
+            CloseHandle(m_Timer);
+        }
+    }
+
+    bool TimerScheduler::IsValid() const
+    {
+        return m_Timer != nullptr;
+    }
+
+    void TimerScheduler::WaitUntil(const std::chrono::steady_clock::time_point deadline)
+    {
+        using namespace std::chrono;
+
+        const auto remaining = duration_cast<nanoseconds>(deadline - steady_clock::now()).count();
+        if (remaining <= 0)
+        {
+            return;
+        }
+        // relative due time in 100 ns units
+        LARGE_INTEGER due;
+        due.QuadPart = -(remaining / 100);
+        if (!SetWaitableTimer(m_Timer, &due, 0, nullptr, nullptr, FALSE) ||
+            WAIT_OBJECT_0 != WaitForSingleObject(m_Timer, INFINITE))
+        {
+            std::this_thread::sleep_until(deadline);
+        }
+    }
+
     Sampler::Sampler(tracker::TrackerBase* tracker,
                      const std::vector<utility::DofValue>& relevant,
                      const std::shared_ptr<output::RecorderBase>& recorder)
         : m_Tracker(tracker), m_Recorder(recorder)
     {
         QueryPerformanceFrequency(&m_CounterFrequency);
-        m_Stabilizer = std::make_shared<filter::BiQuadStabilizer>(relevant);
         GetConfig()->GetBool(Cfg::RecordSamples, m_SampleRecording);
+        if (bool prediction; GetConfig()->GetBool(Cfg::PredictionEnabled, prediction) && prediction)
+        {
+            int horizon{20};
+            GetConfig()->GetInt(Cfg::PredictionMaxHorizon, horizon);
+            const int64_t maxHorizon = std::clamp(static_cast<int64_t>(horizon), int64_t{0}, int64_t{100}) * 1000000;
+            m_Predictor = std::make_unique<filter::KalmanPredictor>(relevant, maxHorizon);
+            // history lookup must not extrapolate further than the predictor
+            m_History.SetMaxExtrapolation(maxHorizon);
+            Log("motion prediction enabled: max horizon = %lld ms", maxHorizon / 1000000);
+        }
+        int oversampling{1};
+        GetConfig()->GetInt(Cfg::StabilizerOversampling, oversampling);
+        oversampling = std::clamp(oversampling, 1, 8);
+        if (oversampling > 1)
+        {
+            m_Decimator = std::make_unique<filter::Decimator>(oversampling);
+            m_Interval = std::chrono::microseconds(1000 / oversampling);
+            Log("input oversampling enabled: factor = %d", oversampling);
+        }
+        // decimated output is published once per regular interval
+        m_PublishInterval = m_Interval * oversampling;
+        const double samplingRate = 1e6 / static_cast<double>(m_PublishInterval.count());
+        m_Stabilizer = std::make_shared<filter::BiQuadStabilizer>(relevant, samplingRate);
+        CreateScheduler();
+        GetConfig()->GetBool(Cfg::StabilizerFrameSync, m_FrameSync);
+        if (m_FrameSync)
+        {
+            Log("frame synchronous sampling enabled");
+        }
+    }
+
+    void Sampler::CreateScheduler()
+    {
+        std::string type{"sleep"};
+        GetConfig()->GetString(Cfg::StabilizerScheduler, type);
+        if ("sleep" == type && m_Interval < std::chrono::milliseconds(1))
+        {
+            // sleep alone can't keep up with oversampling
+            type = "timer";
+        }
+        if ("timer" == type)
+        {
+            if (auto timer = std::make_unique<TimerScheduler>(); timer->IsValid())
+            {
+                m_Scheduler = std::move(timer);
+            }
+            else
+            {
+                // fall back to spinning for a bounded time
+                type = "hybrid";
+            }
+        }
+        if (!m_Scheduler)
+        {
+            if ("hybrid" == type)
+            {
+                // spin only for a fraction of the interval to keep cpu load bounded
+                using namespace std::chrono;
+                microseconds spin = std::min(m_Interval / 10, microseconds(100));
+                if (int spinTime; GetConfig()->GetInt(Cfg::StabilizerSpinTime, spinTime) && spinTime > 0)
+                {
+                    spin = std::min(microseconds(spinTime), m_Interval / 2);
+                }
+                m_Scheduler = std::make_unique<HybridScheduler>(spin);
+                Log("hybrid scheduler spin time: %lld us", spin.count());
+            }
+            else
+            {
+                if ("sleep" != type)
+                {
+                    ErrorLog("%s: invalid scheduler type: %s", __FUNCTION__, type.c_str());
+                    type = "sleep";
+                }
+                m_Scheduler = std::make_unique<SleepScheduler>();
+            }
+        }
+        Log("sampling scheduler: %s", type.c_str());
     }
 
     Sampler::~Sampler()
@@ -47,19 +239,60 @@ namespace sampler
 
         if (!m_IsSampling.load())
         {
-            // try to reconnect
-            if (m_Tracker->GetSource()->Open(0))
+            // try to reconnect, backing off while the source keeps failing
+            if (const auto current = std::chrono::steady_clock::now(); current >= m_NextReconnect)
             {
-                TraceLoggingWriteTagged(local, "Sampler::ReadData", TLArg(true, "Restart"));
-                StartSampling();
-            }
-            else
-            {
-                TraceLoggingWriteStop(local, "Sampler::ReadData", TLArg(false, "Success"));
-                return false;
+                if (m_LastRun.load(std::memory_order_relaxed) >= m_MaxReconnectDelay.count())
+                {
+                    // previous run was healthy
+                    m_ReconnectDelay = m_MinReconnectDelay;
+                }
+                m_NextReconnect = current + m_ReconnectDelay;
+                m_ReconnectDelay = std::min(m_ReconnectDelay * 2, m_MaxReconnectDelay);
+                if (m_Tracker->GetSource()->Open(0))
+                {
+                    StartSampling();
+                }
             }
+            // no fresh sample yet, a source that has stopped updating would otherwise be read successfully
+            TraceLoggingWriteStop(local,
+                                  "Sampler::ReadData",
+                                  TLArg(m_IsSampling.load(), "Restart"),
+                                  TLArg(false, "Success"));
+            return false;
+        }
+        if (const int64_t inserted = m_LastInsert.load(std::memory_order_relaxed); inserted > 0)
+        {
+            const std::chrono::nanoseconds current = std::chrono::steady_clock::now().time_since_epoch();
+            const int64_t sourceAge = m_SourceAge.load(std::memory_order_relaxed);
+            m_SampleAge.Record(std::chrono::nanoseconds(current.count() - inserted + sourceAge));
+        }
+        if (!m_TimeBase.Load().exact)
+        {
+            // sample times can't be related to requested time without runtime clock
+            m_Stabilizer->Read(dof);
+            TraceLoggingWriteStop(local, "Sampler::ReadData", TLArg(true, "Success"), TLArg(false, "ExactTime"));
+            return true;
+        }
+        const XrTime latest = m_History.GetLatestTime();
+        if (const XrDuration lag = CurrentXrTime() - latest; latest > 0 && lag > m_PublishInterval.count() * 1000)
+        {
+            // latest sample should be at most one interval old: sampling falls behind or time base is off
+            m_LateReads.fetch_add(1, std::memory_order_relaxed);
+            TraceLoggingWriteTagged(local, "Sampler::ReadData", TLArg(lag, "LateRead"));
+        }
+        if (m_Predictor && now > latest)
+        {
+            // extrapolate with estimated motion
+            m_Stabilizer->Read(dof);
+            m_Predictor->Predict(dof, now);
+        }
+        else if (!m_History.Get(now, dof))
+        {
+            // requested time is older than history
+            m_Stabilizer->Read(dof);
+            TraceLoggingWriteTagged(local, "Sampler::ReadData", TLArg(false, "InHistory"));
         }
-        m_Stabilizer->Read(dof);
 
         TraceLoggingWriteStop(local, "Sampler::ReadData", TLArg(true, "Success"));
         return true;
@@ -68,27 +301,191 @@ namespace sampler
     void Sampler::SetFrameTime(const XrTime frameTime)
     {
         TraceLocalActivity(local);
-        TraceLoggingWriteStart(local,
-                               "Sampler::SetFrameTime",
-                               TLArg(m_XrFrameTime, "Previous_XrFrameTime"),
-                               TLArg(m_FrameStart.QuadPart, "Previous_FrameStart"));
+        TraceLoggingWriteStart(local, "Sampler::SetFrameTime", TLArg(frameTime, "FrameTime"));
+
+        if (m_TimeBase.Load().exact)
+        {
+            // sample at predicted display time would be out of order with regularly sampled input
+            TraceLoggingWriteStop(local, "Sampler::SetFrameTime", TLArg(false, "Sampled"));
+            return;
+        }
         std::lock_guard lock(m_Tracker->m_SampleMutex);
+        const auto locked = std::chrono::steady_clock::now();
 
-        QueryPerformanceCounter(&m_FrameStart);
-        m_XrFrameTime = frameTime;
+        if (Dof dof; m_Tracker->m_Calibrated)
+        {
+            if (m_Tracker->ReadSource(frameTime, dof))
+            {
+                // sample value
+                m_Stabilizer->Insert(dof, frameTime);
+                Publish(frameTime);
+            }
+            else
+            {
+                m_ReadFailures.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        m_LockHeld.Record(std::chrono::steady_clock::now() - locked);
 
-        TraceLoggingWriteTagged(local,
-                                "Sampler::SetFrameTime",
-                                TLArg(m_XrFrameTime, "New_XrFrameTime"),
-                                TLArg(m_FrameStart.QuadPart, "New_FrameStart"));
-        
-        if (Dof dof; m_Tracker->m_Calibrated && m_Tracker->ReadSource(frameTime, dof))
+        TraceLoggingWriteStop(local, "Sampler::SetFrameTime", TLArg(true, "Sampled"));
+    }
+
+    void Sampler::SetTimeBase(const int64_t counter, const XrTime time, const bool exact)
+    {
+        TraceLoggingWrite(g_traceProvider,
+                          "Sampler::SetTimeBase",
+                          TLArg(counter, "Counter"),
+                          TLArg(time, "Time"),
+                          TLArg(exact, "Exact"));
+
+        m_TimeBase.Store({counter, time, exact});
+    }
+
+    XrTime Sampler::ToXrTime(const int64_t counter) const
+    {
+        const TimeBase base = m_TimeBase.Load();
+        const int64_t elapsed = counter - base.counter;
+        const int64_t frequency = m_CounterFrequency.QuadPart;
+        // split conversion to avoid overflow
+        return base.time + elapsed / frequency * 1000000000 + elapsed % frequency * 1000000000 / frequency;
+    }
+
+    XrTime Sampler::CurrentXrTime() const
+    {
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter(&counter);
+        return ToXrTime(counter.QuadPart);
+    }
+
+    void Sampler::SetFrameTiming(const XrDuration period)
+    {
+        if (!m_FrameSync)
+        {
+            return;
+        }
+        std::lock_guard lock(m_SyncMutex);
+
+        m_FrameWait = std::chrono::steady_clock::now();
+        m_FramePeriod = std::chrono::nanoseconds(period);
+        m_LocatePending = true;
+        if (m_LocateOffset)
+        {
+            // latest sampling cycle of this frame should be finished just before views are located
+            m_SyncTarget = m_FrameWait + *m_LocateOffset - m_SyncLead;
+            m_SyncPending = true;
+        }
+    }
+
+    void Sampler::NotifyLocateViews()
+    {
+        if (!m_FrameSync)
+        {
+            return;
+        }
+        std::lock_guard lock(m_SyncMutex);
+
+        if (!m_LocatePending)
+        {
+            // only the first call within a frame is used for rendering
+            return;
+        }
+        m_LocatePending = false;
+
+        const auto offset = std::chrono::steady_clock::now() - m_FrameWait;
+        if (offset > m_FramePeriod)
+        {
+            // application locates views for a later frame
+            return;
+        }
+        // learn offset between xrWaitFrame and xrLocateViews with an exponential moving average
+        m_LocateOffset = m_LocateOffset ? *m_LocateOffset + (offset - *m_LocateOffset) / 10 : offset;
+        TraceLoggingWrite(g_traceProvider,
+                          "Sampler::NotifyLocateViews",
+                          TLArg(offset.count(), "Offset"),
+                          TLArg(m_LocateOffset->count(), "LearnedOffset"));
+    }
+
+    void Sampler::LockPhase(std::chrono::steady_clock::time_point& deadline)
+    {
+        if (!m_FrameSync)
         {
-            // sample value
-            m_Stabilizer->Insert(dof, frameTime);
+            return;
+        }
+        std::lock_guard lock(m_SyncMutex);
+        if (!m_SyncPending)
+        {
+            return;
         }
+        const auto error = m_SyncTarget - deadline;
+        if (error < -m_Interval / 2)
+        {
+            // target already passed
+            m_SyncPending = false;
+            return;
+        }
+        if (error > m_Interval / 2)
+        {
+            // target is closer to a later cycle
+            return;
+        }
+        // shift cycle onto target, subsequent cycles keep the regular interval from there
+        deadline = m_SyncTarget;
+        m_SyncPending = false;
+    }
 
-        TraceLoggingWriteStop(local, "Sampler::SetFrameTime");
+    Telemetry Sampler::GetTelemetry() const
+    {
+        Telemetry telemetry;
+        telemetry.samplingRate = 1e6 / static_cast<double>(m_Interval.count());
+        telemetry.cpuLoad = m_CpuLoad.load(std::memory_order_relaxed);
+        telemetry.cycles = m_Cycles.load(std::memory_order_relaxed);
+        telemetry.overruns = m_Overruns.load(std::memory_order_relaxed);
+        telemetry.readFailures = m_ReadFailures.load(std::memory_order_relaxed);
+        telemetry.recordDropped = m_RecordDropped.load(std::memory_order_relaxed);
+        telemetry.lateReads = m_LateReads.load(std::memory_order_relaxed);
+        telemetry.jitter = m_Jitter.Get();
+        telemetry.lockHeld = m_LockHeld.Get();
+        telemetry.sampleAge = m_SampleAge.Get();
+        return telemetry;
+    }
+
+    void Sampler::LogTelemetry() const
+    {
+        Log("sampler telemetry: %s", GetTelemetry().ToString().c_str());
+    }
+
+    void Sampler::ResetTelemetry()
+    {
+        m_Cycles.store(0, std::memory_order_relaxed);
+        m_Overruns.store(0, std::memory_order_relaxed);
+        m_ReadFailures.store(0, std::memory_order_relaxed);
+        m_RecordDropped.store(0, std::memory_order_relaxed);
+        m_LateReads.store(0, std::memory_order_relaxed);
+        m_LastInsert.store(0, std::memory_order_relaxed);
+        m_SourceAge.store(0, std::memory_order_relaxed);
+        m_CpuLoad.store(0.0, std::memory_order_relaxed);
+        m_Jitter.Reset();
+        m_LockHeld.Reset();
+        m_SampleAge.Reset();
+    }
+
+    void Sampler::MarkSampleInserted()
+    {
+        const std::chrono::nanoseconds current = std::chrono::steady_clock::now().time_since_epoch();
+        m_LastInsert.store(current.count(), std::memory_order_relaxed);
+    }
+
+    void Sampler::Publish(const XrTime time)
+    {
+        Dof stabilized;
+        m_Stabilizer->Read(stabilized);
+        m_History.Store({stabilized, time});
+        if (m_Predictor)
+        {
+            // estimate motion from stabilized values
+            m_Predictor->Update(stabilized, time);
+        }
+        MarkSampleInserted();
     }
 
     void Sampler::StartSampling()
@@ -100,12 +497,26 @@ namespace sampler
         {
             return;
         }
-        if (m_Thread)
+        if (m_JobStarted)
         {
+            // previous job has ended on its own
             StopSampling();
         }
         m_IsSampling.store(true);
-        m_Thread = new std::thread(&Sampler::DoSampling, this);
+        if (!worker::GetRuntime()->StartSampling([this] { DoSampling(); }))
+        {
+            m_IsSampling.store(false);
+            TraceLoggingWriteStop(local, "Sampler::StartSampling", TLArg(false, "Success"));
+            return;
+        }
+        m_JobStarted = true;
+        if (m_SampleRecording && m_Recorder && !m_RecorderTask)
+        {
+            m_RecorderTask = worker::GetRuntime()->Schedule("sample recorder", std::chrono::milliseconds(5), [this] {
+                return DrainRecordQueue();
+            });
+        }
+        StartStatsPage();
 
         TraceLoggingWriteStop(local, "Sampler::StartSampling");
     }
@@ -116,16 +527,14 @@ namespace sampler
         TraceLoggingWriteStart(local, "Sampler::StopSampling");
 
         m_IsSampling.store(false);
-        if (m_Thread)
+        if (m_JobStarted)
         {
-            if (m_Thread->joinable())
-            {
-                m_Thread->join();
-            }
-            delete m_Thread;
-            m_Thread = nullptr;
+            worker::GetRuntime()->JoinSampling();
+            m_JobStarted = false;
             TraceLoggingWriteTagged(local, "Sampler::StopSampling", TLArg(true, "Stopped"));
         }
+        StopRecording();
+        StopStatsPage();
         if (m_SampleRecording && m_Recorder)
         {
             constexpr Dof zero{};
@@ -136,11 +545,89 @@ namespace sampler
         TraceLoggingWriteStop(local, "Sampler::StopSampling");
     }
 
+    void Sampler::StopRecording()
+    {
+        if (!m_RecorderTask)
+        {
+            return;
+        }
+        worker::GetRuntime()->Cancel(m_RecorderTask);
+        m_RecorderTask = 0;
+        // sampling has stopped, write remaining values from calling thread
+        DrainRecordQueue();
+        if (const uint64_t dropped = m_RecordDropped.load(); dropped > 0)
+        {
+            ErrorLog("%s: recorder fell behind, %llu samples not recorded", __FUNCTION__, dropped);
+        }
+    }
+
+    void Sampler::StartStatsPage()
+    {
+        if (m_StatsTask)
+        {
+            return;
+        }
+        if (!m_StatsPage.Open(m_StatsPageName))
+        {
+            ErrorLog("%s: unable to open %s: %s",
+                     __FUNCTION__,
+                     m_StatsPageName,
+                     shm::SharedMemory::LastError().c_str());
+            return;
+        }
+        m_StatsTask = worker::GetRuntime()->Schedule("sampler stats page", std::chrono::seconds(1), [this] {
+            m_StatsPage.Publish(GetTelemetry().ToPage());
+            return true;
+        });
+    }
+
+    void Sampler::StopStatsPage()
+    {
+        if (!m_StatsTask)
+        {
+            return;
+        }
+        worker::GetRuntime()->Cancel(m_StatsTask);
+        m_StatsTask = 0;
+        // final values of the run stay readable until the next run or the end of the process
+        m_StatsPage.Publish(GetTelemetry().ToPage());
+    }
+
+    bool Sampler::DrainRecordQueue()
+    {
+        SampleRecord record;
+        while (m_RecordQueue.Pop(record))
+        {
+            m_Recorder->WriteSample(record);
+        }
+        return true;
+    }
+
     void Sampler::DoSampling()
     {
         using namespace std::chrono;
 
-        m_Stabilizer->SetStartTime(m_XrFrameTime);
+        m_Stabilizer->SetStartTime(CurrentXrTime());
+        {
+            std::lock_guard lock(m_Tracker->m_SampleMutex);
+            if (m_Predictor)
+            {
+                m_Predictor->Reset();
+            }
+            if (m_Decimator)
+            {
+                m_Decimator->Reset();
+            }
+            m_History.Reset();
+        }
+
+        const auto samplingStart = steady_clock::now();
+        const int64_t cpuStart = GetThreadCpuTime();
+        auto loadUpdate = samplingStart;
+        auto reportStart = samplingStart;
+        int64_t reportCpu = cpuStart;
+        auto deadline = samplingStart;
+        ResetTelemetry();
 
         while (m_IsSampling.load())
         {
@@ -150,29 +637,90 @@ namespace sampler
                 now = steady_clock::now();
 
                 // determine sampling time
-                LARGE_INTEGER current;
-                QueryPerformanceCounter(&current);
-                const auto sinceFrame = (current.QuadPart - m_FrameStart.QuadPart) * 1000000000 / m_CounterFrequency.QuadPart;
-                const XrTime time = m_XrFrameTime + sinceFrame;
+                const XrTime time = CurrentXrTime();
 
                 // sample value
                 Dof dof;
                 if (!m_Tracker->ReadSource(time, dof))
                 {
+                    m_ReadFailures.fetch_add(1, std::memory_order_relaxed);
                     break;
                 }
-                m_Stabilizer->Insert(dof, time);
+                m_Cycles.fetch_add(1, std::memory_order_relaxed);
+                if (const auto sourceAge = m_Tracker->GetSource()->GetSampleAge())
+                {
+                    // producer timestamp of versioned mmf
+                    m_SourceAge.store(sourceAge->count(), std::memory_order_relaxed);
+                }
+                // oversampled input is only passed on at the end of each decimation period
+                if (TimedDof sample{dof, time}; !m_Decimator || m_Decimator->Push({dof, time}, sample))
+                {
+                    m_Stabilizer->Insert(sample.dof, sample.time);
+                    Publish(sample.time);
 
-                // record sample
-                if (m_SampleRecording && m_Recorder)
+                    // hand sample over to recorder thread, paired with read and momentary values of this cycle
+                    if (m_SampleRecording && m_Recorder)
+                    {
+                        SampleRecord record{m_Recorder->GetDofValues(),
+                                            sample.time,
+                                            duration_cast<nanoseconds>(now.time_since_epoch()).count()};
+                        record.values.sampled = sample.dof;
+                        if (!m_RecordQueue.Push(record))
+                        {
+                            m_RecordDropped.fetch_add(1, std::memory_order_relaxed);
+                        }
+                    }
+                }
+                m_LockHeld.Record(steady_clock::now() - now);
+            }
+            deadline += m_Interval;
+            LockPhase(deadline);
+            if (now - loadUpdate >= seconds(1))
+            {
+                const int64_t cpu = GetThreadCpuTime();
+                m_CpuLoad.store(CpuLoad(cpu - cpuStart, now - samplingStart), std::memory_order_relaxed);
+                loadUpdate = now;
+                if (now - reportStart >= seconds(10))
                 {
-                    m_Recorder->AddDofValues(dof, Sampled);
-                    m_Recorder->Write(true);
+                    DebugLog("sampler: cpu load of last 10 s = %.2f %%, %s",
+                             CpuLoad(cpu - reportCpu, now - reportStart),
+                             GetTelemetry().ToString().c_str());
+                    reportStart = now;
+                    reportCpu = cpu;
                 }
             }
-            // wait for next sampling cycle
-            std::this_thread::sleep_until(now + m_Interval);
+
+            // wait for next sampling cycle, based on previous deadline to avoid drift
+            if (const auto current = steady_clock::now(); current > deadline)
+            {
+                // cycle overran: resynchronize instead of catching up with a burst of samples
+                m_Overruns.fetch_add(1, std::memory_order_relaxed);
+                m_Jitter.Record(current - deadline);
+                deadline = current;
+                continue;
+            }
+            m_Scheduler->WaitUntil(deadline);
+            m_Jitter.Record(steady_clock::now() - deadline);
         }
         m_IsSampling.store(false);
+
+        const auto elapsed = steady_clock::now() - samplingStart;
+        m_LastRun.store(duration_cast<milliseconds>(elapsed).count(), std::memory_order_relaxed);
+        if (const double seconds = duration<double>(elapsed).count(); seconds > 0.0)
+        {
+            const double rate = static_cast<double>(m_Cycles.load()) / seconds;
+            const double load = CpuLoad(GetThreadCpuTime() - cpuStart, elapsed);
+            m_CpuLoad.store(load, std::memory_order_relaxed);
+            if (elapsed < m_MaxReconnectDelay)
+            {
+                // short runs repeat at the reconnect rate while the source is failing
+                DebugLog("sampling at %.0f Hz finished after %.0f ms, cpu load = %.2f %%", rate, seconds * 1e3, load);
+            }
+            else
+            {
+                Log("sampling at %.0f Hz finished, cpu load = %.2f %%", rate, load);
+                LogTelemetry();
+            }
+        }
     }
 } // namespace sampler
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "tracker.h"
 #include "filter.h"
 #include "output.h"
+#include "worker.h"
 
 namespace tracker
 {
@@ -12,6 +13,84 @@ namespace tracker
 }
 namespace sampler
 {
+    // payload of the sampler statistics page, a versioned mmf updated once a second, see developer's manual
+    struct TelemetryPage
+    {
+        double samplingRate;
+        double cpuLoad;
+        uint64_t cycles;
+        uint64_t overruns;
+        uint64_t readFailures;
+        uint64_t recordDropped;
+        uint64_t lateReads;
+        // mean and maximum in microseconds
+        double jitterMean;
+        uint64_t jitterMaximum;
+        double lockHeldMean;
+        uint64_t lockHeldMaximum;
+        double sampleAgeMean;
+        uint64_t sampleAgeMaximum;
+    };
+    static_assert(sizeof(TelemetryPage) == 104);
+
+    struct Telemetry
+    {
+        // configured rate of the sampling cycle in Hz, including oversampling
+        double samplingRate{0.0};
+        // cpu time of the sampling thread relative to wall time since sampling started in percent
+        double cpuLoad{0.0};
+        uint64_t cycles{0};
+        uint64_t overruns{0};
+        uint64_t readFailures{0};
+        uint64_t recordDropped{0};
+        // reads with latest sample older than one sampling interval on the runtime clock
+        uint64_t lateReads{0};
+        // delay between scheduled and actual start of sampling cycle
+        utility::LatencyHistogram::Snapshot jitter{};
+        // duration the sample mutex is held by sampler
+        utility::LatencyHistogram::Snapshot lockHeld{};
+        // time elapsed since latest stabilizer input on read access, including its age at the source if known
+        utility::LatencyHistogram::Snapshot sampleAge{};
+        [[nodiscard]] std::string ToString() const;
+        [[nodiscard]] TelemetryPage ToPage() const;
+    };
+
+    class SchedulerBase
+    {
+      public:
+        virtual ~SchedulerBase() = default;
+        // block calling thread until the absolute deadline has passed
+        virtual void WaitUntil(std::chrono::steady_clock::time_point deadline) = 0;
+    };
+
+    class SleepScheduler final : public SchedulerBase
+    {
+      public:
+        void WaitUntil(std::chrono::steady_clock::time_point deadline) override;
+    };
+
+    class HybridScheduler final : public SchedulerBase
+    {
+      public:
+        explicit HybridScheduler(std::chrono::microseconds spin) : m_Spin(spin){};
+        void WaitUntil(std::chrono::steady_clock::time_point deadline) override;
+
+      private:
+        std::chrono::microseconds m_Spin;
+    };
+
+    class TimerScheduler final : public SchedulerBase
+    {
+      public:
+        TimerScheduler();
+        ~TimerScheduler() override;
+        [[nodiscard]] bool IsValid() const;
+        void WaitUntil(std::chrono::steady_clock::time_point deadline) override;
+
+      private:
+        HANDLE m_Timer{nullptr};
+    };
+
     class Sampler
     {
       public:
@@ -25,19 +104,86 @@ namespace sampler
         void StopSampling();
         bool ReadData(utility::Dof& dof, XrTime now);
         void SetFrameTime(XrTime frameTime);
+        // map performance counter to runtime clock, exact if converted by the runtime
+        void SetTimeBase(int64_t counter, XrTime time, bool exact);
+        void SetFrameTiming(XrDuration period);
+        void NotifyLocateViews();
+        [[nodiscard]] Telemetry GetTelemetry() const;
+        void LogTelemetry() const;
 
       private:
         void DoSampling();
+        void Publish(XrTime time);
+        void CreateScheduler();
+        bool DrainRecordQueue();
+        void ResetTelemetry();
+        void MarkSampleInserted();
+        void StopRecording();
+        void StartStatsPage();
+        void StopStatsPage();
+        void LockPhase(std::chrono::steady_clock::time_point& deadline);
+        [[nodiscard]] XrTime ToXrTime(int64_t counter) const;
+        [[nodiscard]] XrTime CurrentXrTime() const;
 
         std::atomic_bool m_IsSampling{false};
-        std::thread* m_Thread{nullptr};
+        bool m_JobStarted{false};
+        // reconnect attempts of the render thread, delay doubles with each attempt until a run lasts long enough
+        static constexpr std::chrono::milliseconds m_MinReconnectDelay{10};
+        static constexpr std::chrono::milliseconds m_MaxReconnectDelay{1000};
+        std::chrono::milliseconds m_ReconnectDelay{m_MinReconnectDelay};
+        std::chrono::steady_clock::time_point m_NextReconnect{};
+        // duration of the latest sampling run in ms
+        std::atomic_int64_t m_LastRun{0};
         tracker::TrackerBase* m_Tracker{nullptr};
         std::shared_ptr<filter::StabilizerBase> m_Stabilizer{};
+        std::unique_ptr<filter::KalmanPredictor> m_Predictor{};
+        filter::SampleHistory m_History{};
+        std::unique_ptr<filter::Decimator> m_Decimator{};
+        std::unique_ptr<SchedulerBase> m_Scheduler{};
+        std::atomic_uint64_t m_Cycles{0};
+        std::atomic_uint64_t m_Overruns{0};
+        std::atomic_uint64_t m_ReadFailures{0};
+        std::atomic_uint64_t m_LateReads{0};
+        std::atomic_int64_t m_LastInsert{0};
+        // age of latest sample at the source when it was read, 0 if unknown
+        std::atomic_int64_t m_SourceAge{0};
+        // updated once a second by the sampling thread
+        std::atomic<double> m_CpuLoad{0.0};
+        utility::LatencyHistogram m_Jitter{};
+        utility::LatencyHistogram m_LockHeld{};
+        utility::LatencyHistogram m_SampleAge{};
         std::chrono::microseconds m_Interval{std::chrono::milliseconds(1)};
+        std::chrono::microseconds m_PublishInterval{std::chrono::milliseconds(1)};
         bool m_SampleRecording{false};
         std::shared_ptr<output::RecorderBase> m_Recorder{};
-        XrTime m_XrFrameTime{};
-        LARGE_INTEGER m_FrameStart{};
+        // sampled values are written to file by a background task to keep disk i/o out of the sampling cycle
+        worker::TaskId m_RecorderTask{0};
+        utility::SpscRing<output::SampleRecord, 1024> m_RecordQueue{};
+        std::atomic_uint64_t m_RecordDropped{0};
+        // telemetry for external tools, published by a background task while sampling
+        static constexpr const char* m_StatsPageName{"Local\\OXRMC_SamplerStats"};
+        utility::MmfPublisher<TelemetryPage> m_StatsPage{};
+        worker::TaskId m_StatsTask{0};
+        struct TimeBase
+        {
+            int64_t counter{0};
+            XrTime time{0};
+            bool exact{false};
+        };
+        // written by render thread once per frame
+        utility::SeqLock<TimeBase> m_TimeBase{};
         LARGE_INTEGER m_CounterFrequency{};
+
+        // align sampling cycles with the first xrLocateViews call of each frame
+        static constexpr std::chrono::microseconds m_SyncLead{200};
+        bool m_FrameSync{false};
+        // guards frame timing below, keeps the render thread independent of the sample mutex
+        std::mutex m_SyncMutex;
+        bool m_LocatePending{false};
+        bool m_SyncPending{false};
+        std::chrono::nanoseconds m_FramePeriod{};
+        std::chrono::steady_clock::time_point m_FrameWait{};
+        std::chrono::steady_clock::time_point m_SyncTarget{};
+        std::optional<std::chrono::nanoseconds> m_LocateOffset{};
     };
 } // namespace sampler
@@ -0,0 +1,169 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#include "pch.h"
+
+#include "shm.h"
+#ifdef _WIN32
+#include "utility.h"
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace shm
+{
+    SharedMemory::~SharedMemory()
+    {
+        Close();
+    }
+
+    bool SharedMemory::IsOpen() const
+    {
+#ifdef _WIN32
+        return m_Handle != nullptr;
+#else
+        return m_Descriptor >= 0;
+#endif
+    }
+
+    void* SharedMemory::GetView() const
+    {
+        return m_View;
+    }
+
+#ifdef _WIN32
+    bool SharedMemory::OpenHandle(const std::string& name, const bool writeable, const size_t size)
+    {
+        m_Writeable = writeable;
+        m_Handle = OpenFileMapping(writeable ? FILE_MAP_READ | FILE_MAP_WRITE : FILE_MAP_READ, FALSE, name.c_str());
+        if (writeable && !m_Handle)
+        {
+            m_Handle = CreateFileMapping(INVALID_HANDLE_VALUE,
+                                         nullptr,
+                                         PAGE_READWRITE,
+                                         0,
+                                         static_cast<DWORD>(size),
+                                         name.c_str());
+        }
+        return m_Handle != nullptr;
+    }
+
+    bool SharedMemory::Map()
+    {
+        m_View = MapViewOfFile(m_Handle, m_Writeable ? FILE_MAP_READ | FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+        return m_View != nullptr;
+    }
+
+    void SharedMemory::Close()
+    {
+        if (m_View)
+        {
+            UnmapViewOfFile(m_View);
+        }
+        m_View = nullptr;
+        if (m_Handle)
+        {
+            CloseHandle(m_Handle);
+        }
+        m_Handle = nullptr;
+    }
+
+    std::string SharedMemory::LastError()
+    {
+        return utility::LastErrorMsg();
+    }
+
+    int64_t Counter()
+    {
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter(&counter);
+        return counter.QuadPart;
+    }
+
+    int64_t CounterFrequency()
+    {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        return frequency.QuadPart;
+    }
+#else
+    namespace
+    {
+        // posix names consist of a leading slash only: 'Local\motionRigPose' -> '/motionRigPose'
+        std::string ToPosixName(const std::string& name)
+        {
+            std::string posix = name.substr(name.find('\\') + 1);
+            std::ranges::replace(posix, '\\', '_');
+            std::ranges::replace(posix, '/', '_');
+            return "/" + posix;
+        }
+    } // namespace
+
+    bool SharedMemory::OpenHandle(const std::string& name, const bool writeable, const size_t size)
+    {
+        m_Writeable = writeable;
+        const std::string posixName = ToPosixName(name);
+        m_Descriptor = shm_open(posixName.c_str(), writeable ? O_RDWR : O_RDONLY, 0);
+        if (writeable && m_Descriptor < 0)
+        {
+            m_Descriptor = shm_open(posixName.c_str(), O_RDWR | O_CREAT, 0666);
+            if (m_Descriptor >= 0 && ftruncate(m_Descriptor, static_cast<off_t>(size)) != 0)
+            {
+                Close();
+            }
+        }
+        return m_Descriptor >= 0;
+    }
+
+    bool SharedMemory::Map()
+    {
+        struct stat status{};
+        if (fstat(m_Descriptor, &status) != 0 || status.st_size <= 0)
+        {
+            return false;
+        }
+        m_Size = static_cast<size_t>(status.st_size);
+        void* view =
+            mmap(nullptr, m_Size, m_Writeable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, m_Descriptor, 0);
+        m_View = MAP_FAILED != view ? view : nullptr;
+        return m_View != nullptr;
+    }
+
+    void SharedMemory::Close()
+    {
+        if (m_View)
+        {
+            munmap(m_View, m_Size);
+        }
+        m_View = nullptr;
+        m_Size = 0;
+        if (m_Descriptor >= 0)
+        {
+            close(m_Descriptor);
+        }
+        m_Descriptor = -1;
+    }
+
+    std::string SharedMemory::LastError()
+    {
+        return std::to_string(errno) + " - " + strerror(errno);
+    }
+
+    int64_t Counter()
+    {
+        timespec now{};
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+    }
+
+    int64_t CounterFrequency()
+    {
+        return 1000000000;
+    }
+#endif
+} // namespace shm
@@ -0,0 +1,44 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#pragma once
+
+namespace shm
+{
+    // named shared memory, backed by file mappings on windows and by shm_open/mmap on posix systems
+    class SharedMemory
+    {
+      public:
+        SharedMemory() = default;
+        SharedMemory(const SharedMemory&) = delete;
+        SharedMemory& operator=(const SharedMemory&) = delete;
+        ~SharedMemory();
+
+        // open existing memory, create it with given size if writeable and not existing yet
+        bool OpenHandle(const std::string& name, bool writeable, size_t size);
+        // map whole memory into address space, requires open handle
+        bool Map();
+        void Close();
+
+        [[nodiscard]] bool IsOpen() const;
+        [[nodiscard]] void* GetView() const;
+
+        // description of the last error of the calling thread
+        static std::string LastError();
+
+      private:
+        bool m_Writeable{false};
+        void* m_View{nullptr};
+#ifdef _WIN32
+        HANDLE m_Handle{nullptr};
+#else
+        int m_Descriptor{-1};
+        size_t m_Size{0};
+#endif
+    };
+
+    // monotonic clock for timestamps shared between processes:
+    // QueryPerformanceCounter on windows, CLOCK_MONOTONIC in nanoseconds on posix systems
+    int64_t Counter();
+    // ticks per second of Counter()
+    int64_t CounterFrequency();
+} // namespace shm
@@ -0,0 +1,14 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#pragma once
+
+// instruction set of vectorized filter loops: FILTER_AVX, FILTER_SSE2 or none (scalar)
+// defining FILTER_SCALAR forces the portable implementation, e.g. to compare results
+#if defined(FILTER_SCALAR)
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define FILTER_AVX
+#elif defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#include <emmintrin.h>
+#define FILTER_SSE2
+#endif
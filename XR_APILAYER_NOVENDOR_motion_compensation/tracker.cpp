@@ -43,7 +43,7 @@ namespace tracker
             m_Recorder->AddPose(m_ReferencePose, Reference);
             m_Recorder->AddPose(curPose, Unfiltered);
 
-            ApplyFilters(curPose);
+            ApplyFilters(curPose, time);
             m_Recorder->AddPose(curPose, Filtered);
 
             ApplyModifier(curPose);
@@ -284,8 +284,6 @@ namespace tracker
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local, "TrackerBase::~TrackerBase");
 
-        delete m_TransFilter;
-        delete m_RotFilter;
         delete m_Sampler;
 
         TraceLoggingWriteStop(local, "TrackerBase::~TrackerBase");
@@ -331,12 +329,26 @@ namespace tracker
         // set up filters
         int orderTrans = 2, orderRot = 2;
         float strengthTrans = 0.0f, strengthRot = 0.0f;
+        std::string typeTrans{"ema"}, typeRot{"slerp"};
         if (!GetConfig()->GetInt(Cfg::TransOrder, orderTrans) || !GetConfig()->GetInt(Cfg::RotOrder, orderRot) ||
             !GetConfig()->GetFloat(Cfg::TransStrength, strengthTrans) ||
-            !GetConfig()->GetFloat(Cfg::RotStrength, strengthRot))
+            !GetConfig()->GetFloat(Cfg::RotStrength, strengthRot) ||
+            !GetConfig()->GetString(Cfg::TransType, typeTrans) || !GetConfig()->GetString(Cfg::RotType, typeRot))
         {
             ErrorLog("%s: unable to read configured values for filters", __FUNCTION__);
         }
+        if ("ema" != typeTrans && "one_euro" != typeTrans)
+        {
+            ErrorLog("%s: invalid type for translational filter: %s", __FUNCTION__, typeTrans.c_str());
+            TraceLoggingWriteStop(local, "TrackerBase::LoadFilters", TLArg(false, "Success"));
+            return false;
+        }
+        if ("slerp" != typeRot && "one_euro" != typeRot)
+        {
+            ErrorLog("%s: invalid type for rotational filter: %s", __FUNCTION__, typeRot.c_str());
+            TraceLoggingWriteStop(local, "TrackerBase::LoadFilters", TLArg(false, "Success"));
+            return false;
+        }
         if (1 > orderTrans || 3 < orderTrans)
         {
             ErrorLog("%s: invalid order for translational filter: %d", __FUNCTION__, orderTrans);
@@ -349,28 +361,54 @@ namespace tracker
             TraceLoggingWriteStop(local, "TrackerBase::LoadFilters", TLArg(false, "Success"));
             return false;
         }
-        // remove previous filter objects
-
-        delete m_TransFilter;
-        delete m_RotFilter;
 
         m_TransStrength = strengthTrans;
         m_RotStrength = strengthRot;
 
+        Log("translational filter type: %s", typeTrans.c_str());
         Log("translational filter stages: %d", orderTrans);
         Log("translational filter strength: %f", m_TransStrength);
-        m_TransFilter = 1 == orderTrans   ? new filter::SingleEmaFilter(m_TransStrength)
-                        : 2 == orderTrans ? new filter::DoubleEmaFilter(m_TransStrength)
-                                          : new filter::TripleEmaFilter(m_TransStrength);
+        if ("one_euro" == typeTrans)
+        {
+            m_TransFilter.emplace<filter::OneEuroTranslationFilter>(m_TransStrength);
+        }
+        else if (1 == orderTrans)
+        {
+            m_TransFilter.emplace<filter::SingleEmaFilter>(m_TransStrength);
+        }
+        else if (2 == orderTrans)
+        {
+            m_TransFilter.emplace<filter::DoubleEmaFilter>(m_TransStrength);
+        }
+        else
+        {
+            m_TransFilter.emplace<filter::TripleEmaFilter>(m_TransStrength);
+        }
 
+        Log("rotational filter type: %s", typeRot.c_str());
         Log("rotational filter stages: %d", orderRot);
         Log("rotational filter strength: %f", m_RotStrength);
-        m_RotFilter = 1 == orderRot   ? new filter::SingleSlerpFilter(m_RotStrength)
-                      : 2 == orderRot ? new filter::DoubleSlerpFilter(m_RotStrength)
-                                      : new filter::TripleSlerpFilter(m_RotStrength);
+        if ("one_euro" == typeRot)
+        {
+            m_RotFilter.emplace<filter::OneEuroRotationFilter>(m_RotStrength);
+        }
+        else if (1 == orderRot)
+        {
+            m_RotFilter.emplace<filter::SingleSlerpFilter>(m_RotStrength);
+        }
+        else if (2 == orderRot)
+        {
+            m_RotFilter.emplace<filter::DoubleSlerpFilter>(m_RotStrength);
+        }
+        else
+        {
+            m_RotFilter.emplace<filter::TripleSlerpFilter>(m_RotStrength);
+        }
 
         TraceLoggingWriteStop(local,
                               "TrackerBase::LoadFilters",
+                              TLArg(typeTrans.c_str(), "TypeTrans"),
+                              TLArg(typeRot.c_str(), "TypeRot"),
                               TLArg(orderTrans, "OrderTrans"),
                               TLArg(m_TransStrength, "TransStrength"),
                               TLArg(orderRot, "OrderRot"),
@@ -394,13 +432,15 @@ namespace tracker
         const float newValue = *currentValue + (increase ? amount : -amount);
         if (trans)
         {
-            *currentValue = m_TransFilter->SetStrength(newValue);
+            *currentValue =
+                std::visit([newValue](auto& filter) { return filter.SetStrength(newValue); }, m_TransFilter);
             GetConfig()->SetValue(Cfg::TransStrength, *currentValue);
             Log("translational filter strength %screased to %f", increase ? "in" : "de", *currentValue);
         }
         else
         {
-            *currentValue = m_RotFilter->SetStrength(newValue);
+            *currentValue =
+                std::visit([newValue](auto& filter) { return filter.SetStrength(newValue); }, m_RotFilter);
             GetConfig()->SetValue(Cfg::RotStrength, *currentValue);
             Log("rotational filter strength %screased to %f", increase ? "in" : "de", *currentValue);
         }
@@ -588,17 +628,50 @@ namespace tracker
         {
             Log("current tracker pose in stage space: %s", xr::ToString(currentPose).c_str());
         }
+        if (m_Sampler)
+        {
+            m_Sampler->LogTelemetry();
+        }
 
         TraceLoggingWriteStop(local, "TrackerBase::LogCurrentTrackerPose");
     }
 
+    void TrackerBase::SetFrameTime(const XrTime time, const XrDuration period)
+    {
+        if (m_Sampler)
+        {
+            // anchor sampling timestamps to the runtime clock once per frame
+            LARGE_INTEGER counter;
+            QueryPerformanceCounter(&counter);
+            const auto layer = reinterpret_cast<OpenXrLayer*>(GetInstance());
+            if (const std::optional<XrTime> now = layer ? layer->ConvertPerformanceCounter(counter) : std::nullopt)
+            {
+                m_Sampler->SetTimeBase(counter.QuadPart, *now, true);
+            }
+            else
+            {
+                // runtime clock unknown: approximate with predicted display time
+                m_Sampler->SetTimeBase(counter.QuadPart, time, false);
+            }
+            m_Sampler->SetFrameTiming(period);
+        }
+    }
+
+    void TrackerBase::NotifyLocateViews() const
+    {
+        if (m_Sampler)
+        {
+            m_Sampler->NotifyLocateViews();
+        }
+    }
+
     void TrackerBase::SetReferencePose(const XrPosef& pose, const bool silent)
     {
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local, "TrackerBase::SetReferencePose", TLArg(xr::ToString(pose).c_str(), "Pose"));
 
-        m_TransFilter->Reset(pose.position);
-        m_RotFilter->Reset(pose.orientation);
+        std::visit([&pose](auto& filter) { filter.Reset(pose.position); }, m_TransFilter);
+        std::visit([&pose](auto& filter) { filter.Reset(pose.orientation); }, m_RotFilter);
         m_Calibrated = true;
         ControllerBase::SetReferencePose(pose, silent);
         if (m_Sampler)
@@ -659,16 +732,16 @@ namespace tracker
         return m_Recorder->Toggle(m_Calibrated);
     }
 
-    void TrackerBase::ApplyFilters(XrPosef& pose)
+    void TrackerBase::ApplyFilters(XrPosef& pose, const XrTime time)
     {
          TraceLocalActivity(local);
          TraceLoggingWriteStart(local, "TrackerBase::ApplyFilters", TLArg(xr::ToString(pose).c_str(), "Pose"));
 
          // apply translational filter
-         m_TransFilter->Filter(pose.position);
+         std::visit([&pose, time](auto& filter) { filter.Filter(pose.position, time); }, m_TransFilter);
 
          // apply rotational filter
-         m_RotFilter->Filter(pose.orientation);
+         std::visit([&pose, time](auto& filter) { filter.Filter(pose.orientation, time); }, m_RotFilter);
 
          TraceLoggingWriteStop(local, "TrackerBase::ApplyFilters", TLArg(xr::ToString(pose).c_str(), "NewPose"));
     }
@@ -893,8 +966,9 @@ namespace tracker
         return true;
     }
 
-    void OpenXrTracker::SetFrameTime(const XrTime time)
+    void OpenXrTracker::SetFrameTime(const XrTime time, const XrDuration period)
     {
+        TrackerBase::SetFrameTime(time, period);
         if (m_Sampler)
         {
             m_Sampler->SetFrameTime(time);
@@ -1481,17 +1555,19 @@ namespace tracker
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local, "RotoVrTracker::ReadSource", TLArg(now, "Now"));
 
-        float yawAngle{};
-        if (!m_Mmf.Read(&yawAngle, sizeof(yawAngle), now))
+        const std::optional<MmfSample<float>> yawAngle = m_View.Get(now);
+        if (!yawAngle.has_value())
         {
             TraceLoggingWriteStop(local, "RotoVrTracker::ReadSource", TLArg(false, "Success"));
             return false;
         }
-        dof = {0, 0, 0, yawAngle, 0, 0};
+        dof = {0, 0, 0, yawAngle->value, 0, 0};
 
         TraceLoggingWriteStop(local,
                               "RotoVrTracker::ReadSource",
-                              TLArg(yawAngle, "Yaw"),
+                              TLArg(yawAngle->value, "Yaw"),
+                              TLArg(yawAngle->stamp.sequence, "Sequence"),
+                              TLArg(yawAngle->stamp.age.count(), "Age"),
                               TLArg(true, "Success"));
         return true;
     }
@@ -1516,19 +1592,22 @@ namespace tracker
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local, "YawTracker::ReadSource", TLArg(now, "Now"));
 
-        YawData mmfData{};
-        if (!m_Mmf.Read(&mmfData, sizeof(mmfData), now))
+        const std::optional<MmfStamp> stamp = m_View.Visit(now, [&dof](const YawData& mmfData) {
+            dof = {0, 0, 0, mmfData.yaw, mmfData.roll, mmfData.pitch};
+        });
+        if (!stamp)
         {
             TraceLoggingWriteStop(local, "YawTracker::ReadSource", TLArg(false, "Success"));
             return false;
         }
-        dof = {0, 0, 0, mmfData.yaw, mmfData.roll, mmfData.pitch};
 
         TraceLoggingWriteStop(local,
                               "YawTracker::ReadSource",
-                              TLArg(mmfData.yaw, "Yaw"),
-                              TLArg(mmfData.roll, "Roll"),
-                              TLArg(mmfData.pitch, "Pitch"),
+                              TLArg(dof.data[yaw], "Yaw"),
+                              TLArg(dof.data[roll], "Roll"),
+                              TLArg(dof.data[pitch], "Pitch"),
+                              TLArg(stamp->sequence, "Sequence"),
+                              TLArg(stamp->age.count(), "Age"),
                               TLArg(true, "Success"));
         return true;
     }
@@ -1553,8 +1632,16 @@ namespace tracker
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local, "SixDofTracker::ReadSource", TLArg(now, "Now"));
         
-        SixDof mmfData{};
-        if (!m_Mmf.Read(&mmfData, sizeof(mmfData), now))
+        // convert directly from mapped memory
+        const std::optional<MmfStamp> stamp = m_View.Visit(now, [&dof](const SixDof& mmfData) {
+            dof.data[sway] = static_cast<float>(mmfData.sway);
+            dof.data[surge] = static_cast<float>(mmfData.surge);
+            dof.data[heave] = static_cast<float>(mmfData.heave);
+            dof.data[yaw] = static_cast<float>(mmfData.yaw);
+            dof.data[pitch] = static_cast<float>(mmfData.pitch);
+            dof.data[roll] = static_cast<float>(mmfData.roll);
+        });
+        if (!stamp)
         {
             TraceLoggingWriteStop(local, "SixDofTracker::ReadSource", TLArg(false, "Read"));
             return false;
@@ -1562,21 +1649,18 @@ namespace tracker
 
         TraceLoggingWriteTagged(local,
                                 "SixDofTracker::ReadSource",
-                                TLArg(mmfData.sway, "Sway"),
-                                TLArg(mmfData.surge, "Surge"),
-                                TLArg(mmfData.heave, "Heave"),
-                                TLArg(mmfData.yaw, "Yaw"),
-                                TLArg(mmfData.roll, "Roll"),
-                                TLArg(mmfData.pitch, "Pitch"));
-
-        dof.data[sway] = static_cast<float>(mmfData.sway);
-        dof.data[surge]= static_cast<float>(mmfData.surge);
-        dof.data[heave] = static_cast<float>(mmfData.heave);
-        dof.data[yaw] = static_cast<float>(mmfData.yaw);
-        dof.data[pitch] = static_cast<float>(mmfData.pitch);
-        dof.data[roll] =  static_cast<float>(mmfData.roll);
-
-        TraceLoggingWriteStop(local, "SixDofTracker::ReadSource", TLArg(true, "Success"));
+                                TLArg(dof.data[sway], "Sway"),
+                                TLArg(dof.data[surge], "Surge"),
+                                TLArg(dof.data[heave], "Heave"),
+                                TLArg(dof.data[yaw], "Yaw"),
+                                TLArg(dof.data[roll], "Roll"),
+                                TLArg(dof.data[pitch], "Pitch"));
+
+        TraceLoggingWriteStop(local,
+                              "SixDofTracker::ReadSource",
+                              TLArg(stamp->sequence, "Sequence"),
+                              TLArg(stamp->age.count(), "Age"),
+                              TLArg(true, "Success"));
         return true;
     }
 
@@ -42,7 +42,7 @@ namespace tracker
         std::shared_ptr<output::RecorderBase> m_Recorder{std::make_shared<output::NoRecorder>()};
 
       private:
-        virtual void ApplyFilters(XrPosef& trackerPose){};
+        virtual void ApplyFilters(XrPosef& trackerPose, XrTime time){};
         virtual void ApplyModifier(XrPosef& trackerPose){};        
     };
 
@@ -74,7 +74,8 @@ namespace tracker
 
         virtual utility::DataSource* GetSource() = 0;
         virtual bool ReadSource(XrTime time, utility::Dof& dof) = 0;
-        virtual void SetFrameTime(const XrTime time) {}
+        virtual void SetFrameTime(XrTime time, XrDuration period);
+        void NotifyLocateViews() const;
 
         bool m_SkipLazyInit{false};
         bool m_LoadPoseFromFile{false};
@@ -83,7 +84,7 @@ namespace tracker
         std::mutex m_SampleMutex;
 
       protected:
-        void ApplyFilters(XrPosef& pose) override;
+        void ApplyFilters(XrPosef& pose, XrTime time) override;
         void ApplyModifier(XrPosef& pose) override;
         bool LoadReferencePose();
         virtual std::optional<XrPosef> GetForwardView(XrSession session, XrTime time);
@@ -99,8 +100,8 @@ namespace tracker
 
         float m_TransStrength{0.0f};
         float m_RotStrength{0.0f};
-        filter::FilterBase<XrVector3f>* m_TransFilter = nullptr;
-        filter::FilterBase<XrQuaternionf>* m_RotFilter = nullptr;
+        filter::TranslationFilter m_TransFilter{};
+        filter::RotationFilter m_RotFilter{};
 
         std::shared_ptr<modifier::TrackerModifier> m_TrackerModifier{};
     };
@@ -115,7 +116,7 @@ namespace tracker
 
         utility::DataSource* GetSource() override;
         bool ReadSource(XrTime time, utility::Dof& dof) override;
-        void SetFrameTime(XrTime time) override;
+        void SetFrameTime(XrTime time, XrDuration period) override;
 
       protected:
         bool GetPose(XrPosef& trackerPose, XrSession session, XrTime time) override;
@@ -193,6 +194,9 @@ namespace tracker
 
       protected:
         XrPosef DataToPose(const utility::Dof& dof) override;
+
+      private:
+        utility::MmfView<float> m_View{m_Mmf};
     };
 
     class YawTracker : public VirtualTracker
@@ -212,6 +216,7 @@ namespace tracker
         {
             float yaw, pitch, roll;
         };
+        utility::MmfView<YawData> m_View{m_Mmf};
     };
 
     class SixDofTracker : public VirtualTracker
@@ -234,6 +239,7 @@ namespace tracker
             double roll;
             double pitch;
         };
+        utility::MmfView<SixDof> m_View{m_Mmf};
     };
 
     class FlyPtTracker final : public SixDofTracker
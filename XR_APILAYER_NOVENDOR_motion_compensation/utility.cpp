@@ -44,6 +44,42 @@ namespace utility
         return angles;
     }
 
+    std::string LatencyHistogram::Snapshot::ToString() const
+    {
+        std::stringstream stream;
+        stream << "count = " << total << ", mean = " << std::fixed << std::setprecision(1) << mean
+               << " us, max = " << maximum << " us, distribution:";
+        for (size_t i = 0; i < m_Buckets; i++)
+        {
+            if (counts[i] > 0)
+            {
+                stream << " <" << (i < m_Buckets - 1 ? std::to_string(1ull << i) : "inf") << "us: " << counts[i];
+            }
+        }
+        return stream.str();
+    }
+
+    XrPosef Interpolate(const XrPosef& earlier, const XrPosef& later, const float alpha)
+    {
+        XrPosef pose;
+        pose.position = {earlier.position.x + (later.position.x - earlier.position.x) * alpha,
+                         earlier.position.y + (later.position.y - earlier.position.y) * alpha,
+                         earlier.position.z + (later.position.z - earlier.position.z) * alpha};
+        pose.orientation = Quaternion::Slerp(earlier.orientation, later.orientation, alpha);
+        return pose;
+    }
+
+    EyePoses Interpolate(const EyePoses& earlier, const EyePoses& later, const float alpha)
+    {
+        EyePoses poses;
+        poses.count = std::min(earlier.count, later.count);
+        for (uint32_t i = 0; i < poses.count; i++)
+        {
+            poses.poses[i] = Interpolate(earlier.poses[i], later.poses[i], alpha);
+        }
+        return poses;
+    }
+
     AutoActivator::AutoActivator(const std::shared_ptr<input::InputHandler>& input)
     {
         m_Input = input;
@@ -102,6 +138,10 @@ namespace utility
                      __FUNCTION__,
                      static_cast<double>(m_Check) / 1000000.0);
         }
+        if (float timeout; GetConfig()->GetFloat(Cfg::TrackerStaleTimeout, timeout))
+        {
+            m_StaleTimeout = static_cast<XrDuration>(std::max(timeout, 0.f) * 1000000000.0);
+        }
     }
 
     Mmf::~Mmf()
@@ -126,32 +166,39 @@ namespace utility
         TraceLoggingWriteStart(local, "Mmf::Open", TLArg(time, "Time"), TLArg(m_WriteAccess, "WriteAccess"));
 
         std::lock_guard lock(m_MmfLock);
-        DWORD access = m_WriteAccess ? FILE_MAP_READ | FILE_MAP_WRITE : FILE_MAP_READ;
-
-        m_FileHandle = OpenFileMapping(access, FALSE, m_Name.c_str());
-
-        if (m_WriteAccess && !m_FileHandle)
+        Reclaim();
+        if (m_Current.load(std::memory_order_acquire))
         {
-            m_FileHandle =
-                CreateFileMapping(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, m_FileSize, m_Name.c_str());
+            // opened by another thread meanwhile, or mapped but not updated anymore
+            const bool stale = IsProducerStale();
+            TraceLoggingWriteStop(local, "Mmf::Open", TLArg(!stale, "Success"), TLArg(stale, "Stale"));
+            return !stale;
         }
-
-        if (m_FileHandle)
+        auto mapping = std::make_unique<Mapping>();
+        if (mapping->memory.OpenHandle(m_Name, m_WriteAccess, m_FileSize))
         {
-            m_View = MapViewOfFile(m_FileHandle, access, 0, 0, 0);
-            if (m_View != nullptr)
+            if (mapping->memory.Map())
             {
-                m_LastRefresh = time;
+                m_LastRefresh.store(time, std::memory_order_relaxed);
                 m_ConnectionLost = false;
+
+                // views are page granular, so the header can be inspected without knowing the file size
+                const auto header = static_cast<const MmfHeader*>(mapping->memory.GetView());
+                mapping->versioned =
+                    !m_WriteAccess && MmfHeader::m_Magic == header->magic && MmfHeader::m_Version == header->version;
+                if (mapping->versioned != m_Versioned.exchange(mapping->versioned))
+                {
+                    Log("mmf '%s' uses %s format", m_Name.c_str(), mapping->versioned ? "versioned" : "legacy");
+                }
+                m_SizeMismatch = false;
+                m_Current.store(mapping.release(), std::memory_order_seq_cst);
             }
             else
             {
                 ErrorLog("%s: unable to map view to mmf '%s': %s",
                          __FUNCTION__,
                          m_Name.c_str(),
-                         LastErrorMsg().c_str());
-                CloseHandle(m_FileHandle);
-                m_FileHandle = nullptr;
+                         shm::SharedMemory::LastError().c_str());
                 TraceLoggingWriteStop(local, "Mmf::Open", TLArg(false, "Success"));
                 return false;
             }
@@ -160,92 +207,168 @@ namespace utility
         {
             if (!m_ConnectionLost)
             {
-                ErrorLog("%s: could not open mmf '%s': %s", __FUNCTION__, m_Name.c_str(), LastErrorMsg().c_str());
+                ErrorLog("%s: could not open mmf '%s': %s",
+                         __FUNCTION__,
+                         m_Name.c_str(),
+                         shm::SharedMemory::LastError().c_str());
                 m_ConnectionLost = true;
             }
             TraceLoggingWriteStop(local, "Mmf::Open", TLArg(false, "Success"));
             return false;
         }
-        TraceLoggingWriteStop(local, "Mmf::Open", TLArg(true, "Success"));
-        return true;
+        // a producer that has stopped leaves its mmf behind, so mapping it doesn't prove a connection
+        const bool stale = IsProducerStale();
+        TraceLoggingWriteStop(local, "Mmf::Open", TLArg(!stale, "Success"), TLArg(stale, "Stale"));
+        return !stale;
     }
 
     bool Mmf::Read(void* buffer, const size_t size, const int64_t time)
     {
-        return ReadWrite(buffer, size, false, time);
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "Mmf::Read", TLArg(time, "Time"));
+
+        const bool success =
+            Access(time, size, [buffer, size](const void* data) { memcpy(buffer, data, size); }).has_value();
+
+        TraceLoggingWriteStop(local, "Mmf::Read", TLArg(success, "Success"));
+        return success;
     }
 
     bool Mmf::Write(void* buffer, size_t size, size_t offset)
     {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "Mmf::Write", TLArg(size, "Size"), TLArg(offset, "Offset"));
+
         if (!m_WriteAccess)
         {
             ErrorLog("%s: unable to write to mmf %s: write access not set", __FUNCTION__, m_Name.c_str());
+            TraceLoggingWriteStop(local, "Mmf::Write", TLArg(false, "WriteAccess"));
+            return false;
+        }
+        Refresh(0);
+        const Pin pin(*this);
+        if (!pin.mapping)
+        {
+            TraceLoggingWriteStop(local, "Mmf::Write", TLArg(false, "View"));
             return false;
         }
-        return ReadWrite(buffer, size, true, 0, offset);
+        memcpy(static_cast<char*>(pin.mapping->memory.GetView()) + offset, buffer, size);
+
+        TraceLoggingWriteStop(local, "Mmf::Write", TLArg(true, "Success"));
+        return true;
     }
 
-    bool Mmf::ReadWrite(void* buffer, const size_t size, bool write, const int64_t time, size_t offset)
+    void Mmf::Refresh(const int64_t time)
     {
-        TraceLocalActivity(local);
-        TraceLoggingWriteStart(local, "Mmf::ReadWrite", TLArg(time, "Time"), TLArg(write, "Write"));
-
-        if (!m_WriteAccess && m_Check > 0 && time - m_LastRefresh > m_Check)
+        if (!m_WriteAccess && m_Check > 0 && time - m_LastRefresh.load(std::memory_order_relaxed) > m_Check)
         {
-            Close();
-        }
-        if (!m_View)
-        {
-            Open(time);
-        }
-        std::lock_guard lock(m_MmfLock);
-        if (m_View)
-        {
-            try
+            // the timestamp of a versioned mmf proves the producer alive, so reopening is only required on staleness
+            if (m_Versioned && m_Current.load(std::memory_order_acquire) && SampleAge().count() < m_Check)
             {
-                if (write)
-                {
-                    void* view = static_cast<char*>(m_View) + offset;
-                    memcpy(view, buffer, size);
-                }
-                else
-                {
-                    memcpy(buffer, m_View, size);
-                }
+                m_LastRefresh.store(time, std::memory_order_relaxed);
             }
-            catch (std::exception& e)
+            else
             {
-                ErrorLog("%s: unable to %s mmf %s: %s", __FUNCTION__, write ? "write to" : "read from", m_Name.c_str(), e.what());
-                // reset mmf connection
                 Close();
-                TraceLoggingWriteStop(local, "Mmf::ReadWrite", TLArg(false, "Memcpy"));
-                return false;
             }
-            TraceLoggingWriteStop(local, "Mmf::ReadWrite", TLArg(true, "Success"));
+        }
+        if (!m_Current.load(std::memory_order_acquire))
+        {
+            Open(time);
+        }
+    }
+
+    bool Mmf::CheckPayloadSize(const MmfHeader* header, const size_t size)
+    {
+        if (header->size >= size)
+        {
             return true;
         }
-        TraceLoggingWriteStop(local, "Mmf::ReadWrite", TLArg(false, "View"));
+        if (!m_SizeMismatch.exchange(true))
+        {
+            ErrorLog("%s: payload of mmf '%s' is too small: %u < %zu",
+                     __FUNCTION__,
+                     m_Name.c_str(),
+                     header->size,
+                     size);
+        }
         return false;
     }
 
+    bool Mmf::IsStale(const MmfStamp& stamp)
+    {
+        if (0 == m_StaleTimeout || stamp.age.count() <= m_StaleTimeout)
+        {
+            if (m_Stale.load(std::memory_order_relaxed) && m_Stale.exchange(false))
+            {
+                Log("mmf '%s' is updated again", m_Name.c_str());
+            }
+            return false;
+        }
+        if (!m_Stale.exchange(true))
+        {
+            ErrorLog("%s: mmf '%s' has not been updated for %.1f ms, sequence: %llu",
+                     __FUNCTION__,
+                     m_Name.c_str(),
+                     static_cast<double>(stamp.age.count()) / 1000000.0,
+                     stamp.sequence);
+        }
+        return true;
+    }
+
+    bool Mmf::IsProducerStale()
+    {
+        const Pin pin(*this);
+        if (!pin.mapping || !pin.mapping->versioned)
+        {
+            // legacy format has no timestamp
+            return false;
+        }
+        auto* header = static_cast<MmfHeader*>(pin.mapping->memory.GetView());
+        const uint64_t sequence = std::atomic_ref(header->sequence).load(std::memory_order_acquire);
+        m_Timestamp.store(std::atomic_ref(header->timestamp).load(std::memory_order_relaxed),
+                          std::memory_order_relaxed);
+        return IsStale({true, sequence, SampleAge()});
+    }
+
+    std::optional<std::chrono::nanoseconds> Mmf::GetSampleAge() const
+    {
+        if (!m_Versioned || !m_Timestamp.load(std::memory_order_relaxed))
+        {
+            return {};
+        }
+        return SampleAge();
+    }
+
+    std::chrono::nanoseconds Mmf::SampleAge() const
+    {
+        const double seconds = static_cast<double>(shm::Counter() - m_Timestamp.load(std::memory_order_relaxed)) /
+                               static_cast<double>(m_CounterFrequency);
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(seconds));
+    }
+
     void Mmf::Close()
     {
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local, "Mmf::Close");
 
         std::lock_guard lock(m_MmfLock);
-        if (m_View)
+        if (Mapping* mapping = m_Current.exchange(nullptr, std::memory_order_seq_cst))
         {
-            UnmapViewOfFile(m_View);
+            m_Retired.emplace_back(mapping);
         }
-        m_View = nullptr;
-        if (m_FileHandle)
+        Reclaim();
+
+        TraceLoggingWriteStop(local, "Mmf::Close", TLArg(m_Retired.size(), "Retired"));
+    }
+
+    void Mmf::Reclaim()
+    {
+        // readers pin before loading the current mapping, so no reader can reach a retired one anymore
+        if (!m_Retired.empty() && !m_Readers.load(std::memory_order_seq_cst))
         {
-            CloseHandle(m_FileHandle);
+            m_Retired.clear();
         }
-        m_FileHandle = nullptr;
-
-        TraceLoggingWriteStop(local, "Mmf::Close");
     }
 
     CorEstimator::CorEstimator(openxr_api_layer::OpenXrLayer* layer)
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <log.h>
+#include "shm.h"
 
 namespace openxr_api_layer
 {
@@ -31,6 +32,12 @@ namespace utility
         float data[6]{};
     } Dof;
 
+    struct TimedDof
+    {
+        Dof dof;
+        int64_t time{0};
+    };
+
     enum DofValue
     {
         sway = 0,
@@ -43,6 +50,100 @@ namespace utility
 
     XrVector3f ToEulerAngles(XrQuaternionf q);
 
+    // single writer / multiple reader publication of trivially copyable values
+    // readers never block the writer, they retry in the (rare) case of a concurrent update
+    template <typename Value>
+    class SeqLock
+    {
+        static_assert(std::is_trivially_copyable_v<Value>);
+
+      public:
+        void Store(const Value& value)
+        {
+            std::array<uint32_t, m_Words> words{};
+            memcpy(words.data(), &value, sizeof(Value));
+
+            const uint32_t sequence = m_Sequence.load(std::memory_order_relaxed);
+            m_Sequence.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            for (size_t i = 0; i < m_Words; i++)
+            {
+                m_Data[i].store(words[i], std::memory_order_relaxed);
+            }
+            m_Sequence.store(sequence + 2, std::memory_order_release);
+        }
+
+        [[nodiscard]] Value Load() const
+        {
+            std::array<uint32_t, m_Words> words{};
+            uint32_t before, after;
+            do
+            {
+                before = m_Sequence.load(std::memory_order_acquire);
+                for (size_t i = 0; i < m_Words; i++)
+                {
+                    words[i] = m_Data[i].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                after = m_Sequence.load(std::memory_order_relaxed);
+            } while (before & 1 || before != after);
+
+            Value value;
+            memcpy(static_cast<void*>(&value), words.data(), sizeof(Value));
+            return value;
+        }
+
+      private:
+        static constexpr size_t m_Words{(sizeof(Value) + sizeof(uint32_t) - 1) / sizeof(uint32_t)};
+
+        std::atomic<uint32_t> m_Sequence{0};
+        std::array<std::atomic<uint32_t>, m_Words> m_Data{};
+    };
+
+    // bounded queue for exactly one producer and one consumer thread
+    // neither side ever blocks, push fails if the consumer falls behind by more than the capacity
+    template <typename Element, size_t Capacity>
+    class SpscRing
+    {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "capacity has to be a power of two");
+
+      public:
+        bool Push(const Element& element)
+        {
+            const size_t head = m_Head.load(std::memory_order_relaxed);
+            if (head - m_Tail.load(std::memory_order_acquire) == Capacity)
+            {
+                return false;
+            }
+            m_Buffer[head & (Capacity - 1)] = element;
+            m_Head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool Pop(Element& element)
+        {
+            const size_t tail = m_Tail.load(std::memory_order_relaxed);
+            if (tail == m_Head.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            element = m_Buffer[tail & (Capacity - 1)];
+            m_Tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        [[nodiscard]] bool Empty() const
+        {
+            return m_Tail.load(std::memory_order_acquire) == m_Head.load(std::memory_order_acquire);
+        }
+
+      private:
+        std::array<Element, Capacity> m_Buffer{};
+        // separate cache lines to avoid false sharing between producer and consumer
+        alignas(64) std::atomic_size_t m_Head{0};
+        alignas(64) std::atomic_size_t m_Tail{0};
+    };
+
     class AutoActivator
     {
       public:
@@ -57,10 +158,109 @@ namespace utility
         XrTime m_ActivationTime{0};
     };
 
-    template <typename Sample>
+    // distribution of durations, e.g. delay between scheduled and actual start of sampling cycles or cache lookup lag
+    class LatencyHistogram
+    {
+      public:
+        // bucket 0: < 1 us, bucket i: [2^(i-1), 2^i) us, last bucket: everything above
+        static constexpr size_t m_Buckets{16};
+
+        struct Snapshot
+        {
+            std::array<uint64_t, m_Buckets> counts{};
+            uint64_t total{0};
+            uint64_t maximum{0};
+            double mean{0.0};
+            [[nodiscard]] std::string ToString() const;
+        };
+
+        void Record(const std::chrono::nanoseconds lateness)
+        {
+            const auto clamped = std::max(lateness, std::chrono::nanoseconds::zero());
+            const auto micro = static_cast<uint64_t>(clamped.count()) / 1000;
+            const size_t bucket = std::min(static_cast<size_t>(std::bit_width(micro)), m_Buckets - 1);
+            m_Counts[bucket].fetch_add(1, std::memory_order_relaxed);
+            m_Sum.fetch_add(micro, std::memory_order_relaxed);
+            uint64_t maximum = m_Maximum.load(std::memory_order_relaxed);
+            while (micro > maximum && !m_Maximum.compare_exchange_weak(maximum, micro, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        void Reset()
+        {
+            for (auto& count : m_Counts)
+            {
+                count.store(0, std::memory_order_relaxed);
+            }
+            m_Sum.store(0, std::memory_order_relaxed);
+            m_Maximum.store(0, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] Snapshot Get() const
+        {
+            Snapshot snapshot;
+            for (size_t i = 0; i < m_Buckets; i++)
+            {
+                snapshot.counts[i] = m_Counts[i].load(std::memory_order_relaxed);
+                snapshot.total += snapshot.counts[i];
+            }
+            snapshot.maximum = m_Maximum.load(std::memory_order_relaxed);
+            if (snapshot.total > 0)
+            {
+                snapshot.mean =
+                    static_cast<double>(m_Sum.load(std::memory_order_relaxed)) / static_cast<double>(snapshot.total);
+            }
+            return snapshot;
+        }
+
+      private:
+        std::array<std::atomic_uint64_t, m_Buckets> m_Counts{};
+        std::atomic_uint64_t m_Sum{0};
+        std::atomic_uint64_t m_Maximum{0};
+    };
+
+    // view poses of up to four views (quad view headsets), stored inline to avoid allocations per frame
+    struct EyePoses
+    {
+        static constexpr uint32_t m_MaxViews{4};
+        std::array<XrPosef, m_MaxViews> poses{};
+        uint32_t count{0};
+    };
+
+    // pose between earlier (alpha = 0) and later (alpha = 1): linear for position, slerp for orientation
+    XrPosef Interpolate(const XrPosef& earlier, const XrPosef& later, float alpha);
+    EyePoses Interpolate(const EyePoses& earlier, const EyePoses& later, float alpha);
+
+    // time ordered ring buffer with fixed capacity, samples are stored in place to avoid allocations per frame
+    template <typename Sample, size_t Capacity = 64>
     class Cache
     {
+        static_assert(std::has_single_bit(Capacity), "cache capacity has to be a power of two");
+
       public:
+        // outcome of sample lookup
+        enum class Match
+        {
+            Exact,
+            Interpolated,
+            Later,
+            Earlier,
+            EstimatedBoth,
+            EstimatedLater,
+            EstimatedEarlier,
+            Fallback
+        };
+        static constexpr size_t m_MatchTypes{8};
+        static constexpr std::array<const char*, m_MatchTypes> m_MatchNames{"exact",
+                                                                            "interpolated",
+                                                                            "later",
+                                                                            "earlier",
+                                                                            "estimated both",
+                                                                            "estimated later",
+                                                                            "estimated earlier",
+                                                                            "fallback"};
+
         explicit Cache(std::string type, Sample fallback) : m_Fallback(fallback), m_SampleType(std::move(type)) {};
 
         void SetTolerance(const XrTime tolerance)
@@ -74,14 +274,27 @@ namespace utility
             TraceLoggingWriteStop(local, "Cache::SetTolerance");
         }
 
-        void AddSample(XrTime time, Sample sample, const bool override)
+        // interpolate between enclosing entries instead of returning the nearest one
+        void SetInterpolation(const bool interpolate)
+        {
+            m_Interpolate = interpolate;
+        }
+
+        // expected distance between entries, wider gaps (e.g. dropped frames) are not interpolated
+        void SetFramePeriod(const XrDuration period)
+        {
+            m_FramePeriod.store(period, std::memory_order_relaxed);
+        }
+
+        void AddSample(XrTime time, const Sample& sample, const bool override)
         {
             using namespace openxr_api_layer::log;
             TraceLocalActivity(local);
             TraceLoggingWriteStart(local, "Cache::AddSample", TLArg(m_SampleType.c_str(), "Type"), TLArg(time, "Time"));
 
             std::lock_guard lock(m_CacheLock);
-            if (m_Cache.contains(time))
+            size_t index = LowerBound(time);
+            if (index < m_Size && At(index).time == time)
             {
                 if (!override)
                 {
@@ -91,12 +304,29 @@ namespace utility
                 }
                 DebugLog("AddSample(%s) at %lld: overriden", m_SampleType.c_str(), time);
                 TraceLoggingWriteTagged(local, "Cache::AddSample", TLArg(true, "Override"));
+                At(index).sample = sample;
+                TraceLoggingWriteStop(local, "Cache::AddSample");
+                return;
             }
-            else
+            if (Capacity == m_Size)
             {
-                DebugLog("AddSample(%s) at %lld: inserted", m_SampleType.c_str(), time);
+                // drop oldest entry
+                DebugLog("AddSample(%s) at %lld: cache full, dropped: %lld", m_SampleType.c_str(), time, At(0).time);
+                TraceLoggingWriteTagged(local, "Cache::AddSample", TLArg(At(0).time, "Dropped"));
+                m_Begin = (m_Begin + 1) & m_Mask;
+                m_Size--;
+                index = index > 0 ? index - 1 : 0;
             }
-            m_Cache[time] = sample;
+            DebugLog("AddSample(%s) at %lld: inserted", m_SampleType.c_str(), time);
+
+            // samples usually arrive in order, so shifting is the exception
+            for (size_t i = m_Size; i > index; i--)
+            {
+                std::swap(At(i), At(i - 1));
+            }
+            At(index).time = time;
+            At(index).sample = sample;
+            m_Size++;
             TraceLoggingWriteStop(local, "Cache::AddSample");
         }
 
@@ -108,58 +338,84 @@ namespace utility
 
             std::lock_guard lock(m_CacheLock);
 
-            auto it = m_Cache.lower_bound(time);
-            const bool itIsEnd = m_Cache.end() == it;
+            const size_t index = LowerBound(time);
+            const bool itIsEnd = m_Size == index;
             if (!itIsEnd)
             {
-                if (it->first == time)
+                const Entry& entry = At(index);
+                if (entry.time == time)
                 {
                     // exact entry found
                     TraceLoggingWriteStop(local,
                                           "Cache::GetSample",
                                           TLArg(m_SampleType.c_str(), "Type"),
                                           TLArg("Exact", "Match"),
-                                          TLArg(it->first, "Time"));
+                                          TLArg(entry.time, "Time"));
 
                     DebugLog("GetSample(%s) at %lld: exact match found", m_SampleType.c_str(), time);
 
+                    Count(Match::Exact, time, entry.time);
                     m_ReportError = true;
-                    return it->second;
+                    return entry.sample;
                 }
-                if (it->first <= time + m_Tolerance)
+                if (m_Interpolate && index > 0 && IsInterpolatable(At(index - 1).time, entry.time, time))
+                {
+                    // requested time is enclosed by two entries
+                    const Entry& lower = At(index - 1);
+                    const auto alpha = static_cast<float>(static_cast<double>(time - lower.time) /
+                                                          static_cast<double>(entry.time - lower.time));
+                    TraceLoggingWriteStop(local,
+                                          "Cache::GetSample",
+                                          TLArg(m_SampleType.c_str(), "Type"),
+                                          TLArg("Interpolated", "Match"),
+                                          TLArg(lower.time, "Earlier"),
+                                          TLArg(entry.time, "Later"));
+                    DebugLog("GetSample(%s) at %lld: interpolated between %lld and %lld",
+                             m_SampleType.c_str(),
+                             time,
+                             lower.time,
+                             entry.time);
+
+                    // lag is the distance to the closer one of both entries
+                    Count(Match::Interpolated, time, alpha < 0.5f ? lower.time : entry.time);
+                    m_ReportError = true;
+                    return Interpolate(lower.sample, entry.sample, alpha);
+                }
+                if (entry.time <= time + m_Tolerance)
                 {
                     // succeeding entry is within tolerance
                     TraceLoggingWriteStop(local,
                                           "Cache::GetSample",
                                           TLArg(m_SampleType.c_str(), "Type"),
                                           TLArg("Later", "Match"),
-                                          TLArg(it->first, "Time"));
-                    DebugLog("GetSample(%s) at %lld: later match found: %lld", m_SampleType.c_str(), time, it->first);
+                                          TLArg(entry.time, "Time"));
+                    DebugLog("GetSample(%s) at %lld: later match found: %lld", m_SampleType.c_str(), time, entry.time);
 
+                    Count(Match::Later, time, entry.time);
                     m_ReportError = true;
-                    return it->second;
+                    return entry.sample;
                 }
             }
-            const bool itIsBegin = m_Cache.begin() == it;
+            const bool itIsBegin = 0 == index;
             if (!itIsBegin)
             {
-                auto lowerIt = it;
-                --lowerIt;
-                if (lowerIt->first >= time - m_Tolerance)
+                const Entry& lower = At(index - 1);
+                if (lower.time >= time - m_Tolerance)
                 {
                     // preceding entry is within tolerance
                     TraceLoggingWriteStop(local,
                                           "Cache::GetSample",
                                           TLArg(m_SampleType.c_str(), "Type"),
                                           TLArg("Earlier", "Match"),
-                                          TLArg(lowerIt->first, "Time"));
+                                          TLArg(lower.time, "Time"));
                     DebugLog("GetSample(%s) at %lld: earlier match found: %lld",
                              m_SampleType.c_str(),
                              time,
-                             lowerIt->first);
+                             lower.time);
 
+                    Count(Match::Earlier, time, lower.time);
                     m_ReportError = true;
-                    return lowerIt->second;
+                    return lower.sample;
                 }
             }
 
@@ -179,45 +435,48 @@ namespace utility
 
             if (!itIsEnd)
             {
+                const Entry& higher = At(index);
                 if (!itIsBegin)
                 {
-                    auto lowerIt = it;
-                    --lowerIt;
+                    const Entry& lower = At(index - 1);
                     // both entries are valid -> select better match
-                    auto returnIt = (time - lowerIt->first < it->first - time ? lowerIt : it);
+                    const Entry& best = (time - lower.time < higher.time - time ? lower : higher);
 
-                    ErrOut("using best match", returnIt->first);
+                    ErrOut("using best match", best.time);
+                    Count(Match::EstimatedBoth, time, best.time);
                     TraceLoggingWriteStop(local,
                                           "Cache::GetSample",
                                           TLArg(m_SampleType.c_str(), "Type"),
                                           TLArg("Estimated Both", "Match"),
-                                          TLArg(it->first, "Time"));
-                    return returnIt->second;
+                                          TLArg(higher.time, "Time"));
+                    return best.sample;
                 }
                 // higher entry is first in cache -> use it
-                ErrOut("using best match", it->first);
+                ErrOut("using best match", higher.time);
+                Count(Match::EstimatedLater, time, higher.time);
                 TraceLoggingWriteStop(local,
                                       "Cache::GetSample",
                                       TLArg(m_SampleType.c_str(), "Type"),
                                       TLArg("Estimated Later", "Match"),
-                                      TLArg(it->first, "Time"));
-                return it->second;
+                                      TLArg(higher.time, "Time"));
+                return higher.sample;
             }
             if (!itIsBegin)
             {
-                auto lowerIt = it;
-                --lowerIt;
+                const Entry& lower = At(index - 1);
                 // lower entry is last in cache-> use it
-                ErrOut("using best match", lowerIt->first);
+                ErrOut("using best match", lower.time);
+                Count(Match::EstimatedEarlier, time, lower.time);
                 TraceLoggingWriteStop(local,
                                       "Cache::GetSample",
                                       TLArg(m_SampleType.c_str(), "Type"),
                                       TLArg("Estimated Earlier", "Match"),
-                                      TLArg(lowerIt->first, "Time"));
-                return lowerIt->second;
+                                      TLArg(lower.time, "Time"));
+                return lower.sample;
             }
             // cache is empty -> return fallback
             ErrOut("using fallback!!!", {});
+            m_Matches[static_cast<size_t>(Match::Fallback)].fetch_add(1, std::memory_order_relaxed);
             TraceLoggingWriteStop(local,
                                   "Cache::GetSample",
                                   TLArg(m_SampleType.c_str(), "Type"),
@@ -225,6 +484,52 @@ namespace utility
             return m_Fallback;
         }
 
+        struct Statistics
+        {
+            std::array<uint64_t, m_MatchTypes> matches{};
+            // distance between requested and returned sample time
+            LatencyHistogram::Snapshot lag{};
+
+            [[nodiscard]] std::string ToString() const
+            {
+                std::stringstream stream;
+                for (size_t i = 0; i < m_MatchTypes; i++)
+                {
+                    stream << m_MatchNames[i] << " = " << matches[i] << ", ";
+                }
+                stream << "lag: " << lag.ToString();
+                return stream.str();
+            }
+        };
+
+        // lookup outcomes since last reset, may be called from any thread
+        [[nodiscard]] Statistics GetStatistics() const
+        {
+            Statistics statistics;
+            for (size_t i = 0; i < m_MatchTypes; i++)
+            {
+                statistics.matches[i] = m_Matches[i].load(std::memory_order_relaxed);
+            }
+            statistics.lag = m_Lag.Get();
+            return statistics;
+        }
+
+        void LogStatistics() const
+        {
+            openxr_api_layer::log::Log("%s cache statistics: %s",
+                                       m_SampleType.c_str(),
+                                       GetStatistics().ToString().c_str());
+        }
+
+        void ResetStatistics()
+        {
+            for (auto& match : m_Matches)
+            {
+                match.store(0, std::memory_order_relaxed);
+            }
+            m_Lag.Reset();
+        }
+
         // remove outdated entries
         void CleanUp(const XrTime time)
         {
@@ -234,27 +539,77 @@ namespace utility
 
             std::lock_guard lock(m_CacheLock);
 
-            auto it = m_Cache.lower_bound(time - m_Tolerance);
-            if (m_Cache.begin() != it)
+            // keep the latest entry preceding the tolerance window
+            if (const size_t index = LowerBound(time - m_Tolerance); index > 1)
             {
-                --it;
-                if (m_Cache.end() != it && m_Cache.begin() != it)
-                {
-                    TraceLoggingWriteTagged(local, "Cache::CleanUp", TLArg(it->first, "Eraaed"));
-                    m_Cache.erase(m_Cache.begin(), it);
-                }
+                const size_t erase = index - 1;
+                TraceLoggingWriteTagged(local, "Cache::CleanUp", TLArg(At(erase).time, "Erased"));
+                // slots are not cleared to allow reuse of memory held by samples
+                m_Begin = (m_Begin + erase) & m_Mask;
+                m_Size -= erase;
             }
 
             TraceLoggingWriteStop(local, "Cache::CleanUp");
         }
 
       private:
-        std::map<XrTime, Sample> m_Cache{};
+        struct Entry
+        {
+            XrTime time{0};
+            Sample sample{};
+        };
+
+        void Count(const Match match, const XrTime requested, const XrTime matched)
+        {
+            m_Matches[static_cast<size_t>(match)].fetch_add(1, std::memory_order_relaxed);
+            m_Lag.Record(std::chrono::nanoseconds(std::abs(requested - matched)));
+        }
+
+        Entry& At(const size_t index)
+        {
+            return m_Entries[(m_Begin + index) & m_Mask];
+        }
+
+        // both neighbours have to be within tolerance and must not span more than one frame (plus jitter)
+        bool IsInterpolatable(const XrTime earlier, const XrTime later, const XrTime time) const
+        {
+            const XrDuration period = m_FramePeriod.load(std::memory_order_relaxed);
+            const XrDuration maxGap = period > 0 ? period * 3 / 2 : 2 * m_Tolerance;
+            return later - earlier <= maxGap && time - earlier <= m_Tolerance && later - time <= m_Tolerance;
+        }
+
+        // index of first entry not preceding given time
+        size_t LowerBound(const XrTime time)
+        {
+            size_t low = 0, high = m_Size;
+            while (low < high)
+            {
+                const size_t mid = low + (high - low) / 2;
+                if (At(mid).time < time)
+                {
+                    low = mid + 1;
+                }
+                else
+                {
+                    high = mid;
+                }
+            }
+            return low;
+        }
+
+        static constexpr size_t m_Mask{Capacity - 1};
+        std::array<Entry, Capacity> m_Entries{};
+        size_t m_Begin{0};
+        size_t m_Size{0};
         mutable std::mutex m_CacheLock;
         Sample m_Fallback;
         XrTime m_Tolerance{2000000};
+        bool m_Interpolate{false};
+        std::atomic<XrDuration> m_FramePeriod{0};
         std::string m_SampleType;
         bool m_ReportError{true};
+        std::array<std::atomic_uint64_t, m_MatchTypes> m_Matches{};
+        LatencyHistogram m_Lag{};
     };
 
     class DataSource
@@ -262,6 +617,104 @@ namespace utility
       public:
         virtual ~DataSource() = default;
         virtual bool Open(int64_t time) = 0;
+        // time since the producer has updated the data, if it provides a timestamp
+        [[nodiscard]] virtual std::optional<std::chrono::nanoseconds> GetSampleAge() const
+        {
+            return {};
+        }
+    };
+
+    // optional header preceding the payload of a tracker source mmf, see developer's manual
+    struct MmfHeader
+    {
+        // bit pattern is NaN when interpreted as float or double, so it can't be mistaken for legacy payload
+        static constexpr uint64_t m_Magic{0x7FF84F587FC04D43};
+        static constexpr uint32_t m_Version{1};
+
+        uint64_t magic;
+        uint32_t version;
+        // payload size in bytes
+        uint32_t size;
+        // incremented before and after each update of the payload, odd while writing
+        uint64_t sequence;
+        // shm::Counter() value at last update
+        int64_t timestamp;
+    };
+    static_assert(sizeof(MmfHeader) == 32);
+
+    // writer side of the versioned mmf format: header followed by a fixed size payload
+    template <typename Payload>
+    class MmfPublisher
+    {
+        static_assert(std::is_trivially_copyable_v<Payload>, "payload is copied into shared memory");
+
+      public:
+        // create or open memory and initialize the header, payload is zeroed
+        bool Open(const std::string& name)
+        {
+            if (m_Page)
+            {
+                return true;
+            }
+            if (!m_Memory.OpenHandle(name, true, sizeof(Page)) || !m_Memory.Map())
+            {
+                m_Memory.Close();
+                return false;
+            }
+            m_Page = static_cast<Page*>(m_Memory.GetView());
+            m_Page->payload = Payload{};
+            m_Page->header = {MmfHeader::m_Magic, MmfHeader::m_Version, sizeof(Payload), 0, shm::Counter()};
+            return true;
+        }
+
+        void Close()
+        {
+            m_Page = nullptr;
+            m_Memory.Close();
+        }
+
+        [[nodiscard]] bool IsOpen() const
+        {
+            return m_Page != nullptr;
+        }
+
+        // sequence is odd while the payload is written, readers retry in that case
+        void Publish(const Payload& payload)
+        {
+            if (!m_Page)
+            {
+                return;
+            }
+            std::atomic_ref sequence(m_Page->header.sequence);
+            sequence.fetch_add(1, std::memory_order_release);
+            std::atomic_thread_fence(std::memory_order_release);
+            m_Page->payload = payload;
+            m_Page->header.timestamp = shm::Counter();
+            sequence.fetch_add(1, std::memory_order_release);
+        }
+
+        [[nodiscard]] uint64_t GetUpdates() const
+        {
+            return m_Page ? std::atomic_ref(m_Page->header.sequence).load(std::memory_order_relaxed) / 2 : 0;
+        }
+
+      private:
+        struct Page
+        {
+            MmfHeader header;
+            Payload payload;
+        };
+
+        shm::SharedMemory m_Memory;
+        Page* m_Page{nullptr};
+    };
+
+    // sequence and age of data read from a mmf, only known for versioned format
+    struct MmfStamp
+    {
+        bool versioned{false};
+        uint64_t sequence{0};
+        std::chrono::nanoseconds age{0};
     };
 
     class Mmf : public DataSource
@@ -275,18 +728,163 @@ namespace utility
         bool Read(void* buffer, size_t size, int64_t time);
         bool Write(void* buffer, size_t size, size_t offset = 0);
         void Close();
+        // time since producer has updated a versioned mmf, empty for legacy format
+        [[nodiscard]] std::optional<std::chrono::nanoseconds> GetSampleAge() const override;
 
       private:
-        bool ReadWrite(void* buffer, size_t size, bool write, int64_t time, size_t offset = 0);
+        struct Mapping
+        {
+            shm::SharedMemory memory;
+            bool versioned{false};
+        };
+
+        // keeps the current mapping alive while it is accessed, closing the mmf retires it instead of unmapping
+        class Pin
+        {
+          public:
+            explicit Pin(Mmf& mmf) : m_Readers(mmf.m_Readers)
+            {
+                m_Readers.fetch_add(1, std::memory_order_seq_cst);
+                mapping = mmf.m_Current.load(std::memory_order_seq_cst);
+            }
+            ~Pin()
+            {
+                m_Readers.fetch_sub(1, std::memory_order_release);
+            }
+            Pin(const Pin&) = delete;
+            Pin& operator=(const Pin&) = delete;
+
+            Mapping* mapping;
+
+          private:
+            std::atomic_int& m_Readers;
+        };
+
+        // call visitor with a pointer to a consistent payload of given size, without locking
+        // fails if a versioned mmf hasn't been updated within stale timeout
+        template <typename Visitor>
+        std::optional<MmfStamp> Access(int64_t time, size_t size, Visitor&& visitor);
+        void Refresh(int64_t time);
+        bool CheckPayloadSize(const MmfHeader* header, size_t size);
+        bool IsStale(const MmfStamp& stamp);
+        // check timestamp of a versioned mapping without reading the payload
+        bool IsProducerStale();
+        void Reclaim();
+        [[nodiscard]] std::chrono::nanoseconds SampleAge() const;
+
+        static constexpr int m_MaxRetries{100};
         XrTime m_Check{1000000000}; // reopen mmf once a second by default
-        XrTime m_LastRefresh{0};
+        XrDuration m_StaleTimeout{250000000};
+        std::atomic<XrTime> m_LastRefresh{0};
         std::string m_Name;
-        HANDLE m_FileHandle{nullptr};
-        DWORD m_FileSize{0};
-        void* m_View{nullptr};
+        size_t m_FileSize{0};
         bool m_WriteAccess{false};
         bool m_ConnectionLost{false};
+        std::atomic_bool m_Versioned{false};
+        std::atomic_bool m_SizeMismatch{false};
+        std::atomic_bool m_Stale{false};
+        std::atomic_int64_t m_Timestamp{0};
+        const int64_t m_CounterFrequency{shm::CounterFrequency()};
+        std::atomic<Mapping*> m_Current{nullptr};
+        std::atomic_int m_Readers{0};
+        // closed mappings, unmapped as soon as no reader is active
+        std::vector<std::unique_ptr<Mapping>> m_Retired{};
+        // serializes open and close
         std::mutex m_MmfLock;
+
+        template <typename Value>
+        friend class MmfView;
+    };
+
+    template <typename Visitor>
+    std::optional<MmfStamp> Mmf::Access(const int64_t time, const size_t size, Visitor&& visitor)
+    {
+        using namespace openxr_api_layer::log;
+
+        Refresh(time);
+        const Pin pin(*this);
+        if (!pin.mapping)
+        {
+            return {};
+        }
+        void* view = pin.mapping->memory.GetView();
+        if (!pin.mapping->versioned)
+        {
+            visitor(view);
+            return MmfStamp{};
+        }
+
+        // seqlock read: retry if the producer is writing or has written meanwhile
+        auto* header = static_cast<MmfHeader*>(view);
+        if (!CheckPayloadSize(header, size))
+        {
+            return {};
+        }
+        std::atomic_ref sequence(header->sequence);
+        for (int attempt = 0; attempt < m_MaxRetries; attempt++)
+        {
+            const uint64_t before = sequence.load(std::memory_order_acquire);
+            if (!(before & 1))
+            {
+                visitor(header + 1);
+                const int64_t timestamp = header->timestamp;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == before)
+                {
+                    m_Timestamp.store(timestamp, std::memory_order_relaxed);
+                    const MmfStamp stamp{true, before, SampleAge()};
+                    if (IsStale(stamp))
+                    {
+                        return {};
+                    }
+                    return stamp;
+                }
+            }
+            std::this_thread::yield();
+        }
+        ErrorLog("%s: unable to read consistent data from mmf '%s'", __FUNCTION__, m_Name.c_str());
+        return {};
+    }
+
+    template <typename Value>
+    struct MmfSample
+    {
+        Value value;
+        MmfStamp stamp;
+    };
+
+    // typed access to the value mapped by a (versioned) mmf without intermediate buffers
+    template <typename Value>
+    class MmfView
+    {
+        static_assert(std::is_trivially_copyable_v<Value>);
+
+      public:
+        explicit MmfView(Mmf& mmf) : m_Mmf(mmf) {};
+
+        [[nodiscard]] std::optional<MmfSample<Value>> Get(const int64_t time)
+        {
+            Value value;
+            const std::optional<MmfStamp> stamp = Visit(time, [&value](const Value& mapped) { value = mapped; });
+            if (!stamp)
+            {
+                return {};
+            }
+            return MmfSample<Value>{value, *stamp};
+        }
+
+        // visitor reads directly from mapped memory and is repeated if the producer has interfered,
+        // so it must not have side effects apart from overwriting its output
+        template <typename Visitor>
+        std::optional<MmfStamp> Visit(const int64_t time, Visitor&& visitor)
+        {
+            return m_Mmf.Access(time, sizeof(Value), [&visitor](const void* data) {
+                visitor(*static_cast<const Value*>(data));
+            });
+        }
+
+      private:
+        Mmf& m_Mmf;
     };
 
     class CorEstimator
@@ -0,0 +1,264 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#include "pch.h"
+
+#include "worker.h"
+#include "config.h"
+#include <log.h>
+
+using namespace openxr_api_layer::log;
+
+namespace worker
+{
+    void Runtime::Configure()
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "Runtime::Configure");
+
+        auto read = [](Cfg priorityKey, Cfg affinityKey, LaneSettings& settings) {
+            if (int priority; GetConfig()->GetInt(priorityKey, priority))
+            {
+                settings.priority = std::clamp(priority, THREAD_PRIORITY_LOWEST, THREAD_PRIORITY_HIGHEST);
+            }
+            if (std::string affinity; GetConfig()->GetString(affinityKey, affinity))
+            {
+                // 64 bit mask to reach cores 32 and above, decimal or hexadecimal with 0x prefix
+                try
+                {
+                    const int base = affinity.starts_with("0x") || affinity.starts_with("0X") ? 16 : 10;
+                    settings.affinity = static_cast<DWORD_PTR>(std::stoull(affinity, nullptr, base));
+                }
+                catch (std::exception& e)
+                {
+                    ErrorLog("%s: unable to convert affinity mask (%s): %s", __FUNCTION__, affinity.c_str(), e.what());
+                }
+            }
+        };
+
+        std::lock_guard lock(m_Mutex);
+        read(Cfg::BackgroundPriority, Cfg::BackgroundAffinity, m_BackgroundSettings);
+        read(Cfg::SamplingPriority, Cfg::SamplingAffinity, m_SamplingSettings);
+        Apply(m_Background, m_BackgroundSettings);
+        Apply(m_Sampling, m_SamplingSettings);
+        if (!m_Tasks.empty() && !m_Background.joinable())
+        {
+            // tasks of process lifetime objects survive destruction of the instance
+            StartBackground();
+            Log("worker threads: background lane restarted for %zu task(s)", m_Tasks.size());
+        }
+        Log("worker threads: background priority = %d, affinity = %#llx, sampling priority = %d, affinity = %#llx",
+            m_BackgroundSettings.priority,
+            static_cast<uint64_t>(m_BackgroundSettings.affinity),
+            m_SamplingSettings.priority,
+            static_cast<uint64_t>(m_SamplingSettings.affinity));
+
+        TraceLoggingWriteStop(local, "Runtime::Configure");
+    }
+
+    TaskId Runtime::Schedule(const std::string& name, const std::chrono::milliseconds interval, Job job)
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local,
+                               "Runtime::Schedule",
+                               TLArg(name.c_str(), "Name"),
+                               TLArg(interval.count(), "Interval"));
+
+        std::lock_guard lock(m_Mutex);
+        const TaskId id = m_NextId++;
+        m_Tasks.push_back({id, name, interval, std::chrono::steady_clock::now(), std::move(job)});
+        StartBackground();
+        m_Condition.notify_all();
+
+        TraceLoggingWriteStop(local, "Runtime::Schedule", TLArg(id, "Id"));
+        return id;
+    }
+
+    void Runtime::Cancel(const TaskId id)
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "Runtime::Cancel", TLArg(id, "Id"));
+
+        std::unique_lock lock(m_Mutex);
+        // the background thread may already be terminated on process exit
+        while (m_Running == id && std::this_thread::get_id() != m_Background.get_id() && IsAlive(m_Background))
+        {
+            m_Condition.wait_for(lock, std::chrono::milliseconds(10));
+        }
+        std::erase_if(m_Tasks, [id](const Task& task) { return task.id == id; });
+
+        TraceLoggingWriteStop(local, "Runtime::Cancel");
+    }
+
+    bool Runtime::StartSampling(std::function<void()> job)
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "Runtime::StartSampling");
+
+        std::lock_guard lock(m_Mutex);
+        if (m_SamplingActive)
+        {
+            ErrorLog("%s: previous sampling job is still running", __FUNCTION__);
+            TraceLoggingWriteStop(local, "Runtime::StartSampling", TLArg(false, "Success"));
+            return false;
+        }
+        m_SamplingJob = std::move(job);
+        m_SamplingActive = true;
+        if (!m_Sampling.joinable())
+        {
+            m_Sampling = std::thread(&Runtime::RunSampling, this);
+            Apply(m_Sampling, m_SamplingSettings);
+        }
+        m_Condition.notify_all();
+
+        TraceLoggingWriteStop(local, "Runtime::StartSampling", TLArg(true, "Success"));
+        return true;
+    }
+
+    void Runtime::JoinSampling()
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "Runtime::JoinSampling");
+
+        std::unique_lock lock(m_Mutex);
+        while (m_SamplingActive && IsAlive(m_Sampling))
+        {
+            m_Condition.wait_for(lock, std::chrono::milliseconds(10));
+        }
+        m_SamplingActive = false;
+        m_SamplingJob = nullptr;
+
+        TraceLoggingWriteStop(local, "Runtime::JoinSampling");
+    }
+
+    void Runtime::Shutdown()
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "Runtime::Shutdown");
+
+        JoinSampling();
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Stop = true;
+            m_Condition.notify_all();
+        }
+        for (std::thread* thread : {&m_Sampling, &m_Background})
+        {
+            if (thread->joinable())
+            {
+                thread->join();
+            }
+        }
+        std::lock_guard lock(m_Mutex);
+        m_Stop = false;
+        Log("worker threads stopped, %zu background task(s) pending", m_Tasks.size());
+
+        TraceLoggingWriteStop(local, "Runtime::Shutdown");
+    }
+
+    void Runtime::StartBackground()
+    {
+        if (!m_Background.joinable())
+        {
+            m_Background = std::thread(&Runtime::RunBackground, this);
+            Apply(m_Background, m_BackgroundSettings);
+        }
+    }
+
+    void Runtime::RunBackground()
+    {
+        using namespace std::chrono;
+
+        SetThreadDescription(GetCurrentThread(), L"OXRMC background");
+        std::unique_lock lock(m_Mutex);
+        while (!m_Stop)
+        {
+            const auto next = std::ranges::min_element(m_Tasks, {}, &Task::due);
+            if (next == m_Tasks.end())
+            {
+                m_Condition.wait(lock);
+                continue;
+            }
+            if (const auto due = next->due; due > steady_clock::now())
+            {
+                m_Condition.wait_until(lock, due);
+                continue;
+            }
+
+            // execute without holding the lock, cancellation waits for completion
+            const TaskId id = m_Running = next->id;
+            const Job job = next->job;
+            lock.unlock();
+            const bool keep = job();
+            lock.lock();
+            m_Running = 0;
+            m_Condition.notify_all();
+
+            if (const auto task = std::ranges::find(m_Tasks, id, &Task::id); task != m_Tasks.end())
+            {
+                if (!keep)
+                {
+                    DebugLog("worker task finished: %s", task->name.c_str());
+                    m_Tasks.erase(task);
+                    continue;
+                }
+                // skip missed executions instead of running them in a burst
+                task->due = std::max(task->due + task->interval, steady_clock::now());
+            }
+        }
+    }
+
+    void Runtime::RunSampling()
+    {
+        SetThreadDescription(GetCurrentThread(), L"OXRMC sampling");
+        std::unique_lock lock(m_Mutex);
+        while (!m_Stop)
+        {
+            if (!m_SamplingJob)
+            {
+                m_Condition.wait(lock);
+                continue;
+            }
+            const std::function<void()> job = std::move(m_SamplingJob);
+            m_SamplingJob = nullptr;
+            lock.unlock();
+            job();
+            lock.lock();
+            m_SamplingActive = false;
+            m_Condition.notify_all();
+        }
+    }
+
+    bool Runtime::IsAlive(std::thread& thread)
+    {
+        return thread.joinable() && WAIT_TIMEOUT == WaitForSingleObject(thread.native_handle(), 0);
+    }
+
+    void Runtime::Apply(std::thread& thread, const LaneSettings& settings)
+    {
+        if (!thread.joinable())
+        {
+            return;
+        }
+        if (!SetThreadPriority(thread.native_handle(), settings.priority))
+        {
+            ErrorLog("%s: unable to set thread priority %d: %d", __FUNCTION__, settings.priority, GetLastError());
+        }
+        if (settings.affinity && !SetThreadAffinityMask(thread.native_handle(), settings.affinity))
+        {
+            ErrorLog("%s: unable to set thread affinity %#llx: %d",
+                     __FUNCTION__,
+                     static_cast<uint64_t>(settings.affinity),
+                     GetLastError());
+        }
+    }
+
+    // intentionally never destroyed: threads can't be joined while the dll is unloaded
+    Runtime* g_Runtime = nullptr;
+
+    Runtime* GetRuntime()
+    {
+        static std::once_flag created;
+        std::call_once(created, [] { g_Runtime = new Runtime(); });
+        return g_Runtime;
+    }
+} // namespace worker
@@ -0,0 +1,77 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#pragma once
+
+namespace worker
+{
+    using TaskId = uint64_t;
+    // periodic job, returning false ends its execution
+    using Job = std::function<bool()>;
+
+    // worker threads shared by all components of the layer:
+    // - background lane: periodic tasks with low priority (mmf communication, recording)
+    // - sampling lane: one long running job at a time with high priority (input stabilizer)
+    class Runtime
+    {
+      public:
+        Runtime() = default;
+        Runtime(const Runtime&) = delete;
+        Runtime& operator=(const Runtime&) = delete;
+
+        // read thread priorities and affinities from config and apply them to running lanes
+        // restarts the background lane if tasks are still registered after a shutdown
+        void Configure();
+
+        TaskId Schedule(const std::string& name, std::chrono::milliseconds interval, Job job);
+        // remove task, blocks while it is executed on the background lane
+        void Cancel(TaskId id);
+
+        // hand job over to sampling lane, fails while a previous job is still running
+        bool StartSampling(std::function<void()> job);
+        // block until current sampling job has returned
+        void JoinSampling();
+
+        // stop both lanes after the sampling job has been finished, registered tasks are kept
+        // lanes are restarted on demand or by Configure
+        void Shutdown();
+
+      private:
+        struct Task
+        {
+            TaskId id;
+            std::string name;
+            std::chrono::milliseconds interval;
+            std::chrono::steady_clock::time_point due;
+            Job job;
+        };
+
+        struct LaneSettings
+        {
+            int priority;
+            DWORD_PTR affinity;
+        };
+
+        // requires lock
+        void StartBackground();
+        void RunBackground();
+        void RunSampling();
+        static bool IsAlive(std::thread& thread);
+        static void Apply(std::thread& thread, const LaneSettings& settings);
+
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        std::vector<Task> m_Tasks{};
+        TaskId m_NextId{1};
+        TaskId m_Running{0};
+        std::function<void()> m_SamplingJob{};
+        bool m_SamplingActive{false};
+        bool m_Stop{false};
+        LaneSettings m_BackgroundSettings{THREAD_PRIORITY_BELOW_NORMAL, 0};
+        LaneSettings m_SamplingSettings{THREAD_PRIORITY_NORMAL, 0};
+        std::thread m_Background{};
+        std::thread m_Sampling{};
+    };
+
+    // Singleton accessor.
+    Runtime* GetRuntime();
+} // namespace worker
@@ -0,0 +1,59 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#pragma once
+
+// Stand-in for the XrMath helpers of the OpenXR-MixedReality submodule: the vector operators and quaternion
+// functions used by the filters, implemented without DirectXMath.
+
+inline XrVector3f operator+(const XrVector3f& a, const XrVector3f& b)
+{
+    return {a.x + b.x, a.y + b.y, a.z + b.z};
+}
+
+inline XrVector3f operator-(const XrVector3f& a, const XrVector3f& b)
+{
+    return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+// element-wise
+inline XrVector3f operator*(const XrVector3f& a, const XrVector3f& b)
+{
+    return {a.x * b.x, a.y * b.y, a.z * b.z};
+}
+
+inline XrVector3f operator*(const XrVector3f& a, const float s)
+{
+    return {a.x * s, a.y * s, a.z * s};
+}
+
+namespace xr::math
+{
+    namespace Quaternion
+    {
+        inline XrQuaternionf Identity()
+        {
+            return {0.f, 0.f, 0.f, 1.f};
+        }
+
+        // shortest path, like XMQuaternionSlerp
+        inline XrQuaternionf Slerp(const XrQuaternionf& a, const XrQuaternionf& b, const float alpha)
+        {
+            float dot = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+            const float sign = dot < 0.f ? -1.f : 1.f;
+            dot *= sign;
+            float weightA = 1.f - alpha, weightB = alpha;
+            if (dot < 0.9999f)
+            {
+                const float angle = std::acos(dot);
+                const float inverse = 1.f / std::sin(angle);
+                weightA = std::sin(weightA * angle) * inverse;
+                weightB = std::sin(weightB * angle) * inverse;
+            }
+            weightB *= sign;
+            return {weightA * a.x + weightB * b.x,
+                    weightA * a.y + weightB * b.y,
+                    weightA * a.z + weightB * b.z,
+                    weightA * a.w + weightB * b.w};
+        }
+    } // namespace Quaternion
+} // namespace xr::math
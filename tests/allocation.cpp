@@ -0,0 +1,55 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#include "pch.h"
+
+#include "allocation.h"
+
+#include <new>
+
+namespace
+{
+    thread_local bool countAllocations{false};
+    thread_local size_t allocations{0};
+} // namespace
+
+namespace allocation
+{
+    Counter::Counter()
+    {
+        allocations = 0;
+        countAllocations = true;
+    }
+
+    Counter::~Counter()
+    {
+        countAllocations = false;
+    }
+
+    size_t Counter::Get() const
+    {
+        return allocations;
+    }
+} // namespace allocation
+
+void* operator new(const size_t size)
+{
+    if (countAllocations)
+    {
+        allocations++;
+    }
+    if (void* memory = malloc(size ? size : 1))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    free(memory);
+}
@@ -0,0 +1,18 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#pragma once
+
+// heap allocations of the current thread while a counter exists, requires allocation.cpp in the executable
+// to replace the global operator new
+namespace allocation
+{
+    class Counter
+    {
+      public:
+        Counter();
+        ~Counter();
+        Counter(const Counter&) = delete;
+        Counter& operator=(const Counter&) = delete;
+        [[nodiscard]] size_t Get() const;
+    };
+} // namespace allocation
@@ -0,0 +1,291 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#include "pch.h"
+
+#include "check.h"
+#include "biquad.h"
+#include "simd.h"
+
+#include <random>
+
+using namespace filter;
+
+namespace
+{
+#if defined(FILTER_AVX)
+    constexpr const char* path{"biquad (avx)"};
+#elif defined(FILTER_SSE2)
+    constexpr const char* path{"biquad (sse2)"};
+#else
+    constexpr const char* path{"biquad (scalar)"};
+#endif
+
+    constexpr double samplingRate{1000.0};
+    constexpr float frequencies[BiQuadBank::m_Channels]{2.f, 5.f, 10.f, 0.5f, 20.f, 1.f, 50.f, 3.f};
+
+    // individual filter object per channel, as used by the stabilizer before the filter bank
+    class BiQuadFilter
+    {
+      public:
+        BiQuadFilter(const float frequency, const double samplingFrequency)
+        {
+            const double r = sin(M_PI_4);
+            const double a = tan(M_PI * frequency / samplingFrequency);
+            const double aSquare = a * a;
+            const double s = (aSquare + 2.0 * a * r + 1.0);
+            m_A = aSquare / s;
+            m_D1 = 2.0 * (1.0 - aSquare) / s;
+            m_D2 = -(aSquare - 2.0 * a * r + 1.0) / s;
+        }
+
+        double Filter(const double value)
+        {
+            m_W0 = m_D1 * m_W1 + m_D2 * m_W2 + value;
+            return m_A * (std::exchange(m_W2, m_W1) + 2.0f * std::exchange(m_W1, m_W0) + m_W0);
+        }
+
+      private:
+        double m_A, m_D1, m_D2;
+        double m_W0{0.0}, m_W1{0.0}, m_W2{0.0};
+    };
+
+    // deterministic input: slow motion plus vibration, different per channel
+    double Signal(const size_t channel, const int sample)
+    {
+        const double t = sample / samplingRate;
+        return (1.0 + channel) * sin(2.0 * M_PI * 0.3 * t + channel) + 0.05 * sin(2.0 * M_PI * 35.0 * t) +
+               0.1 * channel;
+    }
+
+    std::vector<BiQuadFilter> CreateReference()
+    {
+        std::vector<BiQuadFilter> filters;
+        for (const float frequency : frequencies)
+        {
+            filters.emplace_back(frequency, samplingRate);
+        }
+        return filters;
+    }
+
+    BiQuadBank CreateBank()
+    {
+        BiQuadBank bank;
+        for (size_t channel = 0; channel < BiQuadBank::m_Channels; channel++)
+        {
+            bank.SetFrequency(channel, frequencies[channel], samplingRate);
+        }
+        return bank;
+    }
+
+    // bank produces the same output as individual filters, starting from rest
+    void TestColdStart()
+    {
+        std::vector<BiQuadFilter> reference = CreateReference();
+        BiQuadBank bank = CreateBank();
+        double maxError{0.0};
+        for (int sample = 0; sample < 5000; sample++)
+        {
+            double values[BiQuadBank::m_Channels];
+            for (size_t channel = 0; channel < BiQuadBank::m_Channels; channel++)
+            {
+                values[channel] = Signal(channel, sample);
+            }
+            bank.Filter(values);
+            for (size_t channel = 0; channel < BiQuadBank::m_Channels; channel++)
+            {
+                const double expected = reference[channel].Filter(Signal(channel, sample));
+                maxError = std::max(maxError, std::abs(values[channel] - expected));
+            }
+        }
+        CHECK(maxError <= 1e-12);
+    }
+
+    // closed form steady state matches the attack loop previously run on the first sample
+    void TestWarmStart()
+    {
+        std::vector<BiQuadFilter> reference = CreateReference();
+        BiQuadBank bank = CreateBank();
+        double first[BiQuadBank::m_Channels];
+        for (size_t channel = 0; channel < BiQuadBank::m_Channels; channel++)
+        {
+            first[channel] = Signal(channel, 0);
+            for (int i = 0; i < 1e5; i++)
+            {
+                reference[channel].Filter(first[channel]);
+            }
+        }
+        bank.Prime(first);
+
+        double maxError{0.0};
+        for (int sample = 0; sample < 5000; sample++)
+        {
+            double values[BiQuadBank::m_Channels];
+            for (size_t channel = 0; channel < BiQuadBank::m_Channels; channel++)
+            {
+                values[channel] = Signal(channel, sample);
+            }
+            bank.Filter(values);
+            for (size_t channel = 0; channel < BiQuadBank::m_Channels; channel++)
+            {
+                const double expected = reference[channel].Filter(Signal(channel, sample));
+                maxError = std::max(maxError, std::abs(values[channel] - expected));
+                if (0 == sample)
+                {
+                    // no transient: first output equals first input
+                    CHECK_NEAR(values[channel], first[channel], 1e-9);
+                }
+            }
+        }
+        CHECK(maxError <= 1e-6);
+    }
+
+    // deactivated channels output zero
+    void TestUnused()
+    {
+        BiQuadBank bank = CreateBank();
+        bank.SetFrequency(3, 0.f, samplingRate);
+        bank.SetFrequency(7, -1.f, samplingRate);
+        double values[BiQuadBank::m_Channels]{1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
+        bank.Prime(values);
+        bank.Filter(values);
+        CHECK(0.0 == values[3]);
+        CHECK(0.0 == values[7]);
+        CHECK_NEAR(values[0], 1.0, 1e-9);
+    }
+
+    // moving the reference point of a channel offsets its output without transient
+    void TestShift()
+    {
+        std::vector<BiQuadFilter> reference = CreateReference();
+        BiQuadBank bank = CreateBank();
+        constexpr double offset{0.25};
+        double maxError{0.0};
+        for (int sample = 0; sample < 2000; sample++)
+        {
+            if (1000 == sample)
+            {
+                bank.Shift(2, offset);
+            }
+            double values[BiQuadBank::m_Channels];
+            for (size_t channel = 0; channel < BiQuadBank::m_Channels; channel++)
+            {
+                values[channel] = Signal(channel, sample) - (sample >= 1000 && 2 == channel ? offset : 0.0);
+            }
+            bank.Filter(values);
+            const double expected = reference[2].Filter(Signal(2, sample)) - (sample >= 1000 ? offset : 0.0);
+            maxError = std::max(maxError, std::abs(values[2] - expected));
+        }
+        CHECK(maxError <= 1e-9);
+    }
+
+    // changing coefficients (adaptive sampling rate) keeps a constant output constant
+    void TestSetCoefficients()
+    {
+        BiQuadBank bank = CreateBank();
+        double values[BiQuadBank::m_Channels]{2.0, 2.0, 2.0, 2.0, 2.0, 2.0, 2.0, 2.0};
+        bank.Prime(values);
+        for (size_t channel = 0; channel < BiQuadBank::m_Channels; channel++)
+        {
+            bank.SetCoefficients(channel, BiQuadBank::Design(frequencies[channel], samplingRate / 3.0));
+        }
+        for (int sample = 0; sample < 10; sample++)
+        {
+            std::fill(std::begin(values), std::end(values), 2.0);
+            bank.Filter(values);
+            for (const double value : values)
+            {
+                CHECK_NEAR(value, 2.0, 1e-9);
+            }
+        }
+    }
+
+    // gain at the cutoff frequency for sampling intervals drawn uniformly from [shortest, longest] nanoseconds,
+    // coefficients designed for the averaged interval per sample (adaptive) or for the nominal rate
+    double GainAtCutoff(const int64_t shortest, const int64_t longest, const bool adaptive)
+    {
+        constexpr float cutoff{5.f};
+        BiQuadBank bank;
+        bank.SetFrequency(0, cutoff, samplingRate);
+        IntervalAverage average;
+        average.Reset(1e9 / samplingRate);
+
+        std::mt19937 random(1);
+        std::uniform_int_distribution<int64_t> interval(shortest, longest);
+        // least squares fit of sine and cosine to the settled output
+        double ss{0.0}, cc{0.0}, sc{0.0}, ys{0.0}, yc{0.0};
+        int64_t time{0};
+        for (int sample = 0; sample < 20000; sample++)
+        {
+            const int64_t elapsed = interval(random);
+            time += elapsed;
+            if (adaptive)
+            {
+                bank.SetCoefficients(0, BiQuadBank::Design(cutoff, 1e9 / average.Update(elapsed)));
+            }
+            const double phase = 2.0 * M_PI * cutoff * static_cast<double>(time) * 1e-9;
+            double values[BiQuadBank::m_Channels]{sin(phase)};
+            bank.Filter(values);
+            if (time > 4000000000)
+            {
+                const double s = sin(phase), c = cos(phase);
+                ss += s * s, cc += c * c, sc += s * c, ys += values[0] * s, yc += values[0] * c;
+            }
+        }
+        const double determinant = ss * cc - sc * sc;
+        const double a = (ys * cc - yc * sc) / determinant;
+        const double b = (yc * ss - ys * sc) / determinant;
+        return std::sqrt(a * a + b * b);
+    }
+
+    // adaptive coefficients keep the -3 dB point with jittered intervals and a sampling rate off the nominal one
+    void TestAdaptiveRate()
+    {
+        const double ideal = sqrt(0.5);
+        // 0.4 - 1.6 ms around the nominal 1 ms
+        const double jittered = GainAtCutoff(400000, 1600000, true);
+        CHECK_NEAR(jittered, ideal, 0.02);
+        CHECK_NEAR(GainAtCutoff(400000, 1600000, false), ideal, 0.02);
+
+        // 1.0 - 2.0 ms, e.g. sampler not keeping up under load
+        const double slow = GainAtCutoff(1000000, 2000000, true);
+        const double fixed = GainAtCutoff(1000000, 2000000, false);
+        CHECK_NEAR(slow, ideal, 0.02);
+        CHECK(std::abs(slow - ideal) < std::abs(fixed - ideal));
+        printf("%s: gain at cutoff (ideal %.3f): jitter %.3f, slow sampling %.3f (fixed design %.3f)\n",
+               path,
+               ideal,
+               jittered,
+               slow,
+               fixed);
+    }
+
+    // cutoff is limited below nyquist frequency
+    void TestDesign()
+    {
+        const BiQuadBank::Coefficients limited = BiQuadBank::Design(450.f, samplingRate);
+        const BiQuadBank::Coefficients nyquist = BiQuadBank::Design(500.f, samplingRate);
+        CHECK_NEAR(limited.a, nyquist.a, 1e-12);
+        const BiQuadBank::Coefficients regular = BiQuadBank::Design(10.f, samplingRate);
+        // unity gain at dc: 4 * a = 1 - d1 - d2
+        CHECK_NEAR(4.0 * regular.a, 1.0 - regular.d1 - regular.d2, 1e-12);
+    }
+} // namespace
+
+int main()
+{
+#if defined(FILTER_AVX) && defined(__GNUC__)
+    if (!__builtin_cpu_supports("avx"))
+    {
+        printf("%s: skipped, avx not supported\n", path);
+        return 77;
+    }
+#endif
+    TestColdStart();
+    TestWarmStart();
+    TestUnused();
+    TestShift();
+    TestSetCoefficients();
+    TestDesign();
+    TestAdaptiveRate();
+    return check::Result(path);
+}
@@ -0,0 +1,401 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#include "pch.h"
+
+#include "allocation.h"
+#include "check.h"
+
+#include <random>
+
+using namespace utility;
+
+namespace
+{
+    constexpr XrDuration period{11111111}; // 90 Hz
+
+    EyePoses ViewPoses(const XrTime time, const uint32_t count)
+    {
+        EyePoses poses{};
+        poses.count = count;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            poses.poses[i] = {{0.f, 0.f, 0.f, 1.f}, {static_cast<float>(time) * 1e-9f, static_cast<float>(i), 0.f}};
+        }
+        return poses;
+    }
+
+    // per frame cache usage of the layer: xrLocateViews adds, xrEndFrame looks up and cleans up
+    void TestEyeCacheAllocations(const bool interpolate)
+    {
+        Cache<EyePoses> cache("eyes", EyePoses{});
+        cache.SetTolerance(period);
+        cache.SetInterpolation(interpolate);
+        cache.SetFramePeriod(period);
+
+        auto RunFrames = [&cache](const XrTime begin, const int frames) {
+            for (int frame = 0; frame < frames; frame++)
+            {
+                const XrTime time = begin + frame * period;
+                cache.AddSample(time, ViewPoses(time, 4), false);
+                // some applications locate views more than once per frame
+                cache.AddSample(time, ViewPoses(time, 4), false);
+                const EyePoses exact = cache.GetSample(time);
+                CHECK(4 == exact.count);
+                // submitted time slightly off the located one
+                const EyePoses near = cache.GetSample(time - period / 4);
+                CHECK(4 == near.count);
+                cache.CleanUp(time - 3 * period);
+            }
+        };
+
+        // warm up: fill the ring buffer once, statistics and strings are set up on first use
+        RunFrames(1000000000, 100);
+
+        const allocation::Counter counter;
+        RunFrames(1000000000 + 100 * period, 1000);
+        CHECK(0 == counter.Get());
+
+        const auto statistics = cache.GetStatistics();
+        const uint64_t interpolated = statistics.matches[static_cast<size_t>(Cache<EyePoses>::Match::Interpolated)];
+        CHECK(interpolate ? interpolated > 0 : 0 == interpolated);
+    }
+
+    EyePoses Poses(const float x)
+    {
+        EyePoses poses{};
+        poses.count = 2;
+        poses.poses[0] = poses.poses[1] = {{0.f, 0.f, 0.f, 1.f}, {x, 0.f, 0.f}};
+        return poses;
+    }
+
+    // returns the position of the looked up sample, checks the match type
+    float Lookup(Cache<EyePoses>& cache, const XrTime time, const Cache<EyePoses>::Match match)
+    {
+        const size_t index = static_cast<size_t>(match);
+        const uint64_t before = cache.GetStatistics().matches[index];
+        const float x = cache.GetSample(time).poses[0].position.x;
+        CHECK(cache.GetStatistics().matches[index] == before + 1);
+        return x;
+    }
+
+    // interpolation only applies between neighbours within tolerance that are not too far apart
+    void TestInterpolation()
+    {
+        using Match = Cache<EyePoses>::Match;
+        constexpr XrTime begin{1000000000};
+        const check::Quiet quiet;
+
+        // blended value between enclosing entries
+        {
+            Cache<EyePoses> cache("eyes", EyePoses{});
+            cache.SetTolerance(period);
+            cache.SetInterpolation(true);
+            cache.SetFramePeriod(period);
+            cache.AddSample(begin, Poses(0.f), false);
+            cache.AddSample(begin + period, Poses(1.f), false);
+            CHECK_NEAR(Lookup(cache, begin + period / 4, Match::Interpolated), 0.25f, 1e-6f);
+            CHECK_NEAR(Lookup(cache, begin + period * 3 / 4, Match::Interpolated), 0.75f, 1e-6f);
+            CHECK(0.f == Lookup(cache, begin, Match::Exact));
+
+            // disabled interpolation returns the nearest entry within tolerance
+            cache.SetInterpolation(false);
+            CHECK(1.f == Lookup(cache, begin + period / 4, Match::Later));
+        }
+
+        // gap wider than 1.5 frame periods, e.g. dropped frame
+        {
+            Cache<EyePoses> cache("eyes", EyePoses{});
+            cache.SetTolerance(2 * period);
+            cache.SetInterpolation(true);
+            cache.SetFramePeriod(period);
+            cache.AddSample(begin, Poses(0.f), false);
+            cache.AddSample(begin + 2 * period, Poses(1.f), false);
+            CHECK(1.f == Lookup(cache, begin + period, Match::Later));
+
+            cache.AddSample(begin + 3 * period + period / 2, Poses(2.f), false);
+            CHECK_NEAR(Lookup(cache, begin + 3 * period, Match::Interpolated), 5.f / 3.f, 1e-6f);
+        }
+
+        // unknown frame period: gap limited to twice the tolerance
+        {
+            constexpr XrDuration tolerance{period / 2};
+            Cache<EyePoses> cache("eyes", EyePoses{});
+            cache.SetTolerance(tolerance);
+            cache.SetInterpolation(true);
+            cache.AddSample(begin, Poses(0.f), false);
+            cache.AddSample(begin + 2 * tolerance, Poses(1.f), false);
+            cache.AddSample(begin + 4 * tolerance + 1, Poses(2.f), false);
+            CHECK_NEAR(Lookup(cache, begin + tolerance, Match::Interpolated), 0.5f, 1e-6f);
+            CHECK(1.f == Lookup(cache, begin + 3 * tolerance, Match::Earlier));
+        }
+
+        // neighbour outside tolerance
+        {
+            Cache<EyePoses> cache("eyes", EyePoses{});
+            cache.SetTolerance(period / 4);
+            cache.SetInterpolation(true);
+            cache.SetFramePeriod(period);
+            cache.AddSample(begin, Poses(0.f), false);
+            cache.AddSample(begin + period, Poses(1.f), false);
+            CHECK(0.f == Lookup(cache, begin + period / 8, Match::Earlier));
+            CHECK(1.f == Lookup(cache, begin + period * 7 / 8, Match::Later));
+            CHECK(0.f == Lookup(cache, begin + period / 3, Match::EstimatedBoth));
+        }
+    }
+
+    // sample identified by the time it was added at and a version to detect overrides
+    struct Tag
+    {
+        XrTime time{0};
+        int version{0};
+
+        bool operator==(const Tag&) const = default;
+    };
+
+    // needed to instantiate the cache, not used with interpolation disabled
+    Tag Interpolate(const Tag& earlier, const Tag&, float)
+    {
+        return earlier;
+    }
+
+    using TagCache = Cache<Tag>;
+
+    // lookup semantics of the std::map based cache the ring buffer replaced, plus dropping the oldest entry when full
+    template <typename Sample>
+    class ReferenceCache
+    {
+      public:
+        using Match = typename Cache<Sample>::Match;
+
+        ReferenceCache(const XrTime tolerance, Sample fallback) : m_Tolerance(tolerance), m_Fallback(fallback) {}
+
+        void AddSample(const XrTime time, const Sample& sample, const bool override)
+        {
+            if (m_Cache.contains(time))
+            {
+                if (override)
+                {
+                    m_Cache[time] = sample;
+                }
+                return;
+            }
+            if (m_Cache.size() == m_Capacity)
+            {
+                m_Cache.erase(m_Cache.begin());
+            }
+            m_Cache[time] = sample;
+        }
+
+        std::pair<Sample, Match> GetSample(const XrTime time) const
+        {
+            const auto it = m_Cache.lower_bound(time);
+            const bool itIsEnd = m_Cache.end() == it;
+            if (!itIsEnd)
+            {
+                if (it->first == time)
+                {
+                    return {it->second, Match::Exact};
+                }
+                if (it->first <= time + m_Tolerance)
+                {
+                    return {it->second, Match::Later};
+                }
+            }
+            const bool itIsBegin = m_Cache.begin() == it;
+            if (!itIsBegin)
+            {
+                const auto lower = std::prev(it);
+                if (lower->first >= time - m_Tolerance)
+                {
+                    return {lower->second, Match::Earlier};
+                }
+                if (!itIsEnd)
+                {
+                    return {time - lower->first < it->first - time ? lower->second : it->second, Match::EstimatedBoth};
+                }
+                return {lower->second, Match::EstimatedEarlier};
+            }
+            if (!itIsEnd)
+            {
+                return {it->second, Match::EstimatedLater};
+            }
+            return {m_Fallback, Match::Fallback};
+        }
+
+        void CleanUp(const XrTime time)
+        {
+            auto it = m_Cache.lower_bound(time - m_Tolerance);
+            if (m_Cache.begin() != it)
+            {
+                --it;
+                if (m_Cache.begin() != it)
+                {
+                    m_Cache.erase(m_Cache.begin(), it);
+                }
+            }
+        }
+
+      private:
+        static constexpr size_t m_Capacity{64};
+        const XrTime m_Tolerance;
+        const Sample m_Fallback;
+        std::map<XrTime, Sample> m_Cache;
+    };
+
+    // randomized operation sequences yield the same samples and match types as the reference
+    void TestReference(const bool cleanUp, const unsigned seed)
+    {
+        constexpr XrDuration tolerance{2000000};
+        // misses are part of the sequence
+        const check::Quiet quiet;
+        TagCache cache("reference", Tag{-1, -1});
+        cache.SetTolerance(tolerance);
+        ReferenceCache<Tag> reference(tolerance, Tag{-1, -1});
+
+        std::mt19937 random(seed);
+        auto Uniform = [&random](const int64_t min, const int64_t max) {
+            return std::uniform_int_distribution<int64_t>(min, max)(random);
+        };
+
+        XrTime now{1000000000};
+        int version{0};
+        int mismatches{0};
+        for (int step = 0; step < 20000; step++)
+        {
+            const int64_t operation = Uniform(0, 99);
+            if (operation < 40)
+            {
+                // mostly in order, some late arrivals and repeated times on a coarse grid
+                now += Uniform(0, 3) * 1000000;
+                const XrTime time = operation < 30 ? now : now - Uniform(1, 20) * 1000000;
+                reference.AddSample(time, {time, version}, operation % 3 == 0);
+                cache.AddSample(time, {time, version}, operation % 3 == 0);
+                version++;
+            }
+            else if (operation < 95 || !cleanUp)
+            {
+                // exact, within tolerance on either side, and far off
+                const XrTime time = now + Uniform(-40, 10) * 500000 + (operation % 2 ? 0 : Uniform(-100, 100));
+                const auto statistics = cache.GetStatistics();
+                const Tag sample = cache.GetSample(time);
+                const auto [expected, match] = reference.GetSample(time);
+                const auto after = cache.GetStatistics();
+                const size_t matchIndex = static_cast<size_t>(match);
+                if (!(sample == expected) || after.matches[matchIndex] != statistics.matches[matchIndex] + 1)
+                {
+                    mismatches++;
+                }
+            }
+            else
+            {
+                const XrTime time = now - Uniform(0, 10) * 1000000;
+                reference.CleanUp(time);
+                cache.CleanUp(time);
+            }
+        }
+        CHECK(0 == mismatches);
+    }
+
+    // keeps results alive without affecting the measured loop much
+    volatile float sink{0.f};
+
+    // time per call in ns
+    template <typename Function>
+    double Time(const size_t iterations, Function&& function)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++)
+        {
+            function(i);
+        }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / static_cast<double>(iterations);
+    }
+
+    // ring buffer (with locking and statistics) against the std::map based cache it replaced, informational only
+    void MeasureRingBuffer(const size_t iterations)
+    {
+        constexpr XrTime begin{1000000000};
+        Cache<EyePoses> cache("eyes", EyePoses{});
+        cache.SetTolerance(period);
+        ReferenceCache<EyePoses> reference(period, EyePoses{});
+
+        // frame loop of the layer: insert at located time, clean up older frames
+        const double ringInsert = Time(iterations, [&cache](const size_t i) {
+            const XrTime time = begin + static_cast<XrTime>(i) * period;
+            cache.AddSample(time, Poses(static_cast<float>(i)), false);
+            cache.CleanUp(time - 3 * period);
+        });
+        const double mapInsert = Time(iterations, [&reference](const size_t i) {
+            const XrTime time = begin + static_cast<XrTime>(i) * period;
+            reference.AddSample(time, Poses(static_cast<float>(i)), false);
+            reference.CleanUp(time - 3 * period);
+        });
+        printf("cache: insert and clean up, ring buffer: %.1f ns, std::map: %.1f ns\n", ringInsert, mapInsert);
+
+        // lookups slightly off the entries of a filled cache
+        const XrTime filled = begin + static_cast<XrTime>(iterations) * period;
+        for (XrTime frame = 0; frame < 32; frame++)
+        {
+            cache.AddSample(filled + frame * period, Poses(static_cast<float>(frame)), false);
+            reference.AddSample(filled + frame * period, Poses(static_cast<float>(frame)), false);
+        }
+        auto Requested = [filled](const size_t i) {
+            return filled + static_cast<XrTime>(i % 32) * period + period / 4;
+        };
+        const double ringLookup = Time(iterations, [&cache, &Requested](const size_t i) {
+            sink = cache.GetSample(Requested(i)).poses[0].position.x;
+        });
+        const double mapLookup = Time(iterations, [&reference, &Requested](const size_t i) {
+            sink = reference.GetSample(Requested(i)).first.poses[0].position.x;
+        });
+        printf("cache: lookup in 32 entries, ring buffer: %.1f ns, std::map: %.1f ns\n", ringLookup, mapLookup);
+    }
+
+    // cost of blending enclosing entries compared to returning the nearest one, informational only
+    void MeasureInterpolation(const size_t iterations)
+    {
+        constexpr XrTime begin{1000000000};
+        double results[2]{};
+        for (const bool interpolate : {false, true})
+        {
+            Cache<EyePoses> cache("eyes", EyePoses{});
+            cache.SetTolerance(period);
+            cache.SetInterpolation(interpolate);
+            cache.SetFramePeriod(period);
+            for (XrTime frame = 0; frame < 32; frame++)
+            {
+                cache.AddSample(begin + frame * period, ViewPoses(begin + frame * period, 2), false);
+            }
+            results[interpolate] = Time(iterations, [&cache](const size_t i) {
+                sink = cache.GetSample(begin + static_cast<XrTime>(i % 31) * period + period / 4).poses[0].position.x;
+            });
+        }
+        printf("cache: lookup between two entries, nearest: %.1f ns, interpolated: %.1f ns\n", results[0], results[1]);
+    }
+
+    // counting works, otherwise the test above proves nothing
+    void TestCounter()
+    {
+        const allocation::Counter counter;
+        auto vector = std::make_unique<std::vector<XrPosef>>(4);
+        CHECK(counter.Get() >= 1);
+    }
+} // namespace
+
+// Usage: cache_test [iterations of the measurements]
+int main(const int argc, const char* argv[])
+{
+    const size_t iterations = argc > 1 ? std::max(std::stoul(argv[1]), 1ul) : 100000;
+    TestCounter();
+    TestEyeCacheAllocations(false);
+    TestEyeCacheAllocations(true);
+    TestInterpolation();
+    // without clean up the capacity is exceeded and the oldest entries are dropped
+    TestReference(false, 1);
+    TestReference(true, 2);
+    TestReference(true, 3);
+    MeasureRingBuffer(iterations);
+    MeasureInterpolation(iterations);
+    return check::Result("cache");
+}
@@ -0,0 +1,42 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#pragma once
+
+// minimal assertions for the test executables: failures are reported and counted, main returns the result
+namespace check
+{
+    inline int failures{0};
+    // suppresses log output of the code under test, e.g. for expected lookup errors
+    inline bool quiet{false};
+
+    class Quiet
+    {
+      public:
+        Quiet()
+        {
+            quiet = true;
+        }
+        ~Quiet()
+        {
+            quiet = false;
+        }
+    };
+
+    inline void Report(const bool success, const char* expression, const char* file, const int line)
+    {
+        if (!success)
+        {
+            fprintf(stderr, "%s(%d): check failed: %s\n", file, line, expression);
+            failures++;
+        }
+    }
+
+    inline int Result(const char* test)
+    {
+        printf("%s: %s\n", test, failures ? "failed" : "passed");
+        return failures ? 1 : 0;
+    }
+} // namespace check
+
+#define CHECK(expression) check::Report(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
+#define CHECK_NEAR(a, b, tolerance) CHECK(std::abs((a) - (b)) <= (tolerance))
@@ -0,0 +1,78 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#include "pch.h"
+
+#include "config.h"
+
+// Stand-in for the configuration manager without ini files: tests set the values they need with SetValue,
+// keys not set leave the defaults of the calling code untouched.
+
+bool ConfigManager::GetBool(const Cfg key, bool& val)
+{
+    int value;
+    if (!GetInt(key, value))
+    {
+        return false;
+    }
+    val = value;
+    return true;
+}
+
+bool ConfigManager::GetInt(const Cfg key, int& val)
+{
+    std::string strVal;
+    if (!GetString(key, strVal))
+    {
+        return false;
+    }
+    val = std::stoi(strVal);
+    return true;
+}
+
+bool ConfigManager::GetFloat(const Cfg key, float& val)
+{
+    std::string strVal;
+    if (!GetString(key, strVal))
+    {
+        return false;
+    }
+    val = std::stof(strVal);
+    return true;
+}
+
+bool ConfigManager::GetString(const Cfg key, std::string& val)
+{
+    const auto it = m_Values.find(key);
+    if (m_Values.end() == it)
+    {
+        return false;
+    }
+    val = it->second;
+    return true;
+}
+
+void ConfigManager::SetValue(const Cfg key, const bool val)
+{
+    SetValue(key, std::to_string(val));
+}
+
+void ConfigManager::SetValue(const Cfg key, const int val)
+{
+    SetValue(key, std::to_string(val));
+}
+
+void ConfigManager::SetValue(const Cfg key, const float val)
+{
+    SetValue(key, std::to_string(val));
+}
+
+void ConfigManager::SetValue(const Cfg key, const std::string& val)
+{
+    m_Values[key] = val;
+}
+
+ConfigManager* GetConfig()
+{
+    static ConfigManager config;
+    return &config;
+}
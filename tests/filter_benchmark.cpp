@@ -0,0 +1,495 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#include "pch.h"
+
+#include "filter.h"
+
+#include "allocation.h"
+#include "config.h"
+#include "simd.h"
+
+#include <random>
+
+using namespace filter;
+using namespace utility;
+
+// Timing, heap allocations and delay of the pose filters, the stabilizer and the pose cache, see developer's manual.
+// Usage: filter_benchmark [iterations]
+
+namespace
+{
+#if defined(FILTER_AVX)
+    constexpr const char* path{"avx"};
+#elif defined(FILTER_SSE2)
+    constexpr const char* path{"sse2"};
+#else
+    constexpr const char* path{"scalar"};
+#endif
+
+    constexpr XrDuration period{11111111}; // 90 Hz
+    constexpr XrTime startTime{1000000000};
+    // default of the configuration file for pose filters and stabilizer
+    constexpr float strength{0.5f};
+    const std::vector<DofValue> allDofs{sway, surge, heave, yaw, roll, pitch};
+
+    // keeps results alive without affecting the measured loop much
+    volatile double sink{0.0};
+
+    template <typename Function>
+    void Measure(const char* name, const size_t iterations, Function&& function)
+    {
+        // warm up caches and branch predictors
+        for (size_t i = 0; i < iterations / 10; i++)
+        {
+            function(i);
+        }
+        const allocation::Counter counter;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++)
+        {
+            function(i);
+        }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        printf("%-36s %10.1f ns %8.3f allocations\n",
+               name,
+               elapsed.count() / static_cast<double>(iterations),
+               static_cast<double>(counter.Get()) / static_cast<double>(iterations));
+    }
+
+    void Configure(const bool adaptiveRate)
+    {
+        ConfigManager* config = GetConfig();
+        config->SetValue(Cfg::TransVerticalFactor, 1.f);
+        config->SetValue(Cfg::TransBeta, 0.5f);
+        config->SetValue(Cfg::RotBeta, 0.5f);
+        config->SetValue(Cfg::StabilizerStrength, strength);
+        for (const Cfg key : {Cfg::StabilizerSway,
+                              Cfg::StabilizerSurge,
+                              Cfg::StabilizerHeave,
+                              Cfg::StabilizerYaw,
+                              Cfg::StabilizerRoll,
+                              Cfg::StabilizerPitch})
+        {
+            config->SetValue(key, 1.f);
+        }
+        config->SetValue(Cfg::StabilizerAdaptiveRate, adaptiveRate);
+    }
+
+    XrQuaternionf AroundY(const double angle)
+    {
+        return {0.f, static_cast<float>(sin(angle / 2.0)), 0.f, static_cast<float>(cos(angle / 2.0))};
+    }
+
+    // pose filters are applied once per frame
+    template <typename Filter>
+    void BenchmarkTranslation(const char* name, const size_t iterations)
+    {
+        Filter filter(strength);
+        filter.Reset({0.f, 0.f, 0.f});
+        Measure(name, iterations, [&filter](const size_t i) {
+            XrVector3f location{static_cast<float>(i & 0xff) * 1e-3f, 0.f, 0.f};
+            filter.Filter(location, startTime + static_cast<XrTime>(i) * period);
+            sink = location.x;
+        });
+    }
+
+    template <typename Filter>
+    void BenchmarkRotation(const char* name, const size_t iterations)
+    {
+        std::array<XrQuaternionf, 256> rotations;
+        for (size_t i = 0; i < rotations.size(); i++)
+        {
+            rotations[i] = AroundY(static_cast<double>(i) * 1e-3);
+        }
+        Filter filter(strength);
+        filter.Reset(rotations[0]);
+        Measure(name, iterations, [&filter, &rotations](const size_t i) {
+            XrQuaternionf rotation = rotations[i & 0xff];
+            filter.Filter(rotation, startTime + static_cast<XrTime>(i) * period);
+            sink = rotation.y;
+        });
+    }
+
+    void BenchmarkFilters(const size_t iterations)
+    {
+        Configure(false);
+        BenchmarkTranslation<SingleEmaFilter>("single ema filter", iterations);
+        BenchmarkTranslation<DoubleEmaFilter>("double ema filter", iterations);
+        BenchmarkTranslation<TripleEmaFilter>("triple ema filter", iterations);
+        BenchmarkTranslation<OneEuroTranslationFilter>("one euro translation filter", iterations);
+        BenchmarkRotation<SingleSlerpFilter>("single slerp filter", iterations);
+        BenchmarkRotation<DoubleSlerpFilter>("double slerp filter", iterations);
+        BenchmarkRotation<TripleSlerpFilter>("triple slerp filter", iterations);
+        BenchmarkRotation<OneEuroRotationFilter>("one euro rotation filter", iterations);
+    }
+
+    void BenchmarkBiQuad(const size_t iterations)
+    {
+        BiQuadBank bank;
+        for (size_t channel = 0; channel < 6; channel++)
+        {
+            bank.SetFrequency(channel, 5.f, 1000.0);
+        }
+        double values[BiQuadBank::m_Channels]{};
+        bank.Prime(values);
+        Measure("biquad bank filter", iterations, [&bank, &values](const size_t i) {
+            for (size_t channel = 0; channel < 6; channel++)
+            {
+                values[channel] = static_cast<double>(i & 0xff) * 1e-3 + static_cast<double>(channel);
+            }
+            bank.Filter(values);
+            sink = values[0];
+        });
+
+        // per sample coefficient update of the adaptive rate mode, design instead of table lookup as upper bound
+        IntervalAverage average;
+        average.Reset(1e6);
+        Measure("biquad bank adaptive filter", iterations, [&bank, &values, &average](const size_t i) {
+            const BiQuadBank::Coefficients coefficients =
+                BiQuadBank::Design(5.f, 1e9 / average.Update(900000 + static_cast<int64_t>(i % 200) * 1000));
+            for (size_t channel = 0; channel < 6; channel++)
+            {
+                bank.SetCoefficients(channel, coefficients);
+                values[channel] = static_cast<double>(i & 0xff) * 1e-3 + static_cast<double>(channel);
+            }
+            bank.Filter(values);
+            sink = values[0];
+        });
+    }
+
+    // pose filter interface before the switch to std::variant: filters held by pointer to base class
+    template <typename Value>
+    class VirtualFilter
+    {
+      public:
+        virtual ~VirtualFilter() = default;
+        virtual void Filter(Value& value, XrTime time) = 0;
+    };
+
+    template <typename Value, typename Implementation>
+    class VirtualAdapter final : public VirtualFilter<Value>
+    {
+      public:
+        explicit VirtualAdapter(const float strength) : m_Filter(strength) {}
+        void Filter(Value& value, const XrTime time) override
+        {
+            m_Filter.Filter(value, time);
+        }
+
+      private:
+        Implementation m_Filter;
+    };
+
+    // filter type is chosen at runtime like in the layer, so the compiler can't resolve virtual calls
+    volatile int order{2};
+
+    template <typename Ema, typename Slerp>
+    void MakeFilters(TranslationFilter& translation,
+                     RotationFilter& rotation,
+                     std::unique_ptr<VirtualFilter<XrVector3f>>& virtualTranslation,
+                     std::unique_ptr<VirtualFilter<XrQuaternionf>>& virtualRotation)
+    {
+        translation.emplace<Ema>(strength);
+        rotation.emplace<Slerp>(strength);
+        virtualTranslation = std::make_unique<VirtualAdapter<XrVector3f, Ema>>(strength);
+        virtualRotation = std::make_unique<VirtualAdapter<XrQuaternionf, Slerp>>(strength);
+    }
+
+    // TrackerBase::ApplyFilters: translational and rotational filter of a pose per frame
+    void BenchmarkDispatch(const size_t iterations)
+    {
+        Configure(false);
+        TranslationFilter translation;
+        RotationFilter rotation;
+        std::unique_ptr<VirtualFilter<XrVector3f>> virtualTranslation;
+        std::unique_ptr<VirtualFilter<XrQuaternionf>> virtualRotation;
+        switch (order)
+        {
+        case 1:
+            MakeFilters<SingleEmaFilter, SingleSlerpFilter>(translation, rotation, virtualTranslation, virtualRotation);
+            break;
+        case 3:
+            MakeFilters<TripleEmaFilter, TripleSlerpFilter>(translation, rotation, virtualTranslation, virtualRotation);
+            break;
+        default:
+            MakeFilters<DoubleEmaFilter, DoubleSlerpFilter>(translation, rotation, virtualTranslation, virtualRotation);
+        }
+        std::array<XrPosef, 256> poses;
+        for (size_t i = 0; i < poses.size(); i++)
+        {
+            poses[i] = {AroundY(static_cast<double>(i) * 1e-3), {static_cast<float>(i) * 1e-3f, 0.f, 0.f}};
+        }
+
+        Measure("apply filters (variant)", iterations, [&translation, &rotation, &poses](const size_t i) {
+            XrPosef pose = poses[i & 0xff];
+            const XrTime time = startTime + static_cast<XrTime>(i) * period;
+            std::visit([&pose, time](auto& filter) { filter.Filter(pose.position, time); }, translation);
+            std::visit([&pose, time](auto& filter) { filter.Filter(pose.orientation, time); }, rotation);
+            sink = pose.position.x + pose.orientation.y;
+        });
+        Measure("apply filters (virtual)",
+                iterations,
+                [&virtualTranslation, &virtualRotation, &poses](const size_t i) {
+                    XrPosef pose = poses[i & 0xff];
+                    const XrTime time = startTime + static_cast<XrTime>(i) * period;
+                    virtualTranslation->Filter(pose.position, time);
+                    virtualRotation->Filter(pose.orientation, time);
+                    sink = pose.position.x + pose.orientation.y;
+                });
+    }
+
+    std::unique_ptr<LowPassStabilizer> MakeStabilizer(const bool biquad, const bool adaptiveRate, const double rate)
+    {
+        Configure(adaptiveRate);
+        std::unique_ptr<LowPassStabilizer> stabilizer;
+        if (biquad)
+        {
+            stabilizer = std::make_unique<BiQuadStabilizer>(allDofs, rate);
+        }
+        else
+        {
+            stabilizer = std::make_unique<EmaStabilizer>(allDofs, rate);
+        }
+        stabilizer->SetStartTime(startTime);
+        return stabilizer;
+    }
+
+    // samples of all dofs at given input rate, inserted individually or in batches published once per millisecond
+    void BenchmarkStabilizer(const bool biquad, const bool adaptiveRate, const double rate, const bool batched,
+                             const size_t iterations)
+    {
+        const auto stabilizer = MakeStabilizer(biquad, adaptiveRate, rate);
+        const auto interval = static_cast<XrTime>(1e9 / rate);
+        const size_t batch = batched ? std::max<size_t>(static_cast<size_t>(rate / 1000.0), 1) : 1;
+        std::vector<TimedDof> samples(batch);
+        char name[64];
+        snprintf(name,
+                 sizeof(name),
+                 "%s %s at %g kHz%s",
+                 biquad ? "biquad" : "ema",
+                 batched ? "batch" : "insert",
+                 rate / 1000.0,
+                 adaptiveRate ? " (adaptive)" : "");
+        // time per sample
+        Measure(name, iterations, [&stabilizer, &samples, batch, interval](const size_t i) {
+            const size_t index = i % batch;
+            Dof& dof = samples[index].dof;
+            dof.data[sway] = dof.data[surge] = dof.data[heave] = static_cast<float>(i & 0xff) * 1e-3f;
+            dof.data[yaw] = dof.data[roll] = dof.data[pitch] = static_cast<float>(i & 0xff) * 1e-2f;
+            // jittered interval for rate adaption
+            const XrTime jitter = static_cast<XrTime>(i % 7) * interval / 50;
+            const XrTime time = startTime + static_cast<XrTime>(i) * interval + jitter;
+            if (1 == batch)
+            {
+                stabilizer->Insert(dof, time);
+                return;
+            }
+            samples[index].time = time;
+            if (batch - 1 == index)
+            {
+                stabilizer->InsertBatch(samples);
+            }
+        });
+    }
+
+    void BenchmarkStabilizers(const size_t iterations)
+    {
+        BenchmarkStabilizer(false, false, 1000.0, false, iterations);
+        BenchmarkStabilizer(true, true, 1000.0, false, iterations);
+        // oversampled input: each sample inserted on its own versus all samples of a millisecond at once
+        for (const double rate : {1000.0, 4000.0, 16000.0})
+        {
+            BenchmarkStabilizer(true, false, rate, false, iterations);
+            BenchmarkStabilizer(true, false, rate, true, iterations);
+        }
+    }
+
+    // filter under test reduced to a single value: input and time in, filtered value out
+    using Channel = std::function<double(double input, XrTime time)>;
+
+    template <typename Filter>
+    Channel TranslationChannel()
+    {
+        return [filter = std::make_shared<Filter>(strength)](const double input, const XrTime time) {
+            XrVector3f location{static_cast<float>(input), 0.f, 0.f};
+            filter->Filter(location, time);
+            return static_cast<double>(location.x);
+        };
+    }
+
+    template <typename Filter>
+    Channel RotationChannel()
+    {
+        return [filter = std::make_shared<Filter>(strength)](const double input, const XrTime time) {
+            XrQuaternionf rotation = AroundY(input);
+            filter->Filter(rotation, time);
+            return 2.0 * atan2(rotation.y, rotation.w);
+        };
+    }
+
+    // translation (sway) or rotation (yaw, radian) through the stabilizer
+    Channel StabilizerChannel(const bool biquad, const bool rotation)
+    {
+        std::shared_ptr<LowPassStabilizer> stabilizer = MakeStabilizer(biquad, false, 1000.0);
+        const DofValue value = rotation ? yaw : sway;
+        const double scale = rotation ? 180.0 / M_PI : 1.0;
+        return [stabilizer, value, scale](const double input, const XrTime time) {
+            Dof dof{};
+            dof.data[value] = static_cast<float>(input * scale);
+            stabilizer->Insert(dof, time);
+            stabilizer->Read(dof);
+            return dof.data[value] / scale;
+        };
+    }
+
+    // delay of the output behind the input: time to pass half of a unit step (m or radian) and phase delay of
+    // sine waves with an amplitude of 5 cm or 0.05 radian (about 3 degrees) after settling for a second,
+    // residual noise: standard deviation of the output relative to gaussian input noise around a constant value
+    void Response(const char* name, const double rate, const std::function<Channel()>& factory)
+    {
+        const XrDuration interval = std::llround(1e9 / rate);
+        const auto samples = [rate](const double seconds) { return std::llround(seconds * rate); };
+
+        double stepDelay = std::numeric_limits<double>::quiet_NaN();
+        Channel channel = factory();
+        const int64_t step = samples(0.1);
+        for (int64_t i = 0; i < step + samples(2.0); i++)
+        {
+            if (channel(i < step ? 0.0 : 1.0, startTime + i * interval) >= 0.5 && i >= step)
+            {
+                stepDelay = static_cast<double>((i - step) * interval) / 1e6;
+                break;
+            }
+        }
+
+        std::mt19937 generator(1);
+        std::normal_distribution<double> noise(0.0, 1e-3);
+        channel = factory();
+        double sum{0.0}, squares{0.0};
+        const int64_t settle = samples(1.0), measure = samples(2.0);
+        for (int64_t i = 0; i < settle + measure; i++)
+        {
+            const double output = channel(noise(generator), startTime + i * interval);
+            if (i >= settle)
+            {
+                sum += output;
+                squares += output * output;
+            }
+        }
+        const double mean = sum / static_cast<double>(measure);
+        const double deviation = sqrt(std::max(squares / static_cast<double>(measure) - mean * mean, 0.0));
+        printf("%-36s step %6.1f ms, noise %4.2f, delay at", name, stepDelay, deviation / noise.stddev());
+
+        // two seconds contain an integral number of periods of each frequency
+        for (const double frequency : {0.5, 1.0, 2.0, 4.0, 8.0})
+        {
+            constexpr double amplitude{0.05};
+            channel = factory();
+            double sine{0.0}, cosine{0.0};
+            for (int64_t i = 0; i < settle + measure; i++)
+            {
+                const double phase = 2.0 * M_PI * frequency * static_cast<double>(i) / rate;
+                const double output = channel(amplitude * sin(phase), startTime + i * interval);
+                if (i >= settle)
+                {
+                    sine += output * sin(phase);
+                    cosine += output * cos(phase);
+                }
+            }
+            // output = gain * sin(phase + shift), shift is negative for delayed output
+            const double shift = atan2(cosine, sine);
+            const double delay = -shift / (2.0 * M_PI * frequency) * 1e3;
+            printf(" %g Hz: %5.1f ms%s", frequency, delay, 8.0 == frequency ? "" : ",");
+        }
+        printf("\n");
+    }
+
+    void MeasureResponses()
+    {
+        Configure(false);
+        printf("delay of filter output (pose filters at 90 Hz, stabilizer at 1 kHz, default strength):\n");
+        const double frameRate = 1e9 / static_cast<double>(period);
+        Response("single ema filter", frameRate, TranslationChannel<SingleEmaFilter>);
+        Response("double ema filter", frameRate, TranslationChannel<DoubleEmaFilter>);
+        Response("triple ema filter", frameRate, TranslationChannel<TripleEmaFilter>);
+        Response("one euro translation filter", frameRate, TranslationChannel<OneEuroTranslationFilter>);
+        Response("single slerp filter", frameRate, RotationChannel<SingleSlerpFilter>);
+        Response("double slerp filter", frameRate, RotationChannel<DoubleSlerpFilter>);
+        Response("triple slerp filter", frameRate, RotationChannel<TripleSlerpFilter>);
+        Response("one euro rotation filter", frameRate, RotationChannel<OneEuroRotationFilter>);
+        Response("ema stabilizer (sway)", 1000.0, [] { return StabilizerChannel(false, false); });
+        Response("biquad stabilizer (sway)", 1000.0, [] { return StabilizerChannel(true, false); });
+        Response("biquad stabilizer (yaw)", 1000.0, [] { return StabilizerChannel(true, true); });
+    }
+
+    EyePoses Poses(const XrTime time)
+    {
+        EyePoses poses{};
+        poses.count = 2;
+        poses.poses[0] = poses.poses[1] = {{0.f, 0.f, 0.f, 1.f}, {static_cast<float>(time % 1000), 0.f, 0.f}};
+        return poses;
+    }
+
+    void BenchmarkCache(const size_t iterations)
+    {
+        for (const bool interpolate : {false, true})
+        {
+            Cache<EyePoses> cache("eyes", EyePoses{});
+            cache.SetTolerance(period);
+            cache.SetInterpolation(interpolate);
+            cache.SetFramePeriod(period);
+            // regular frame loop: locate views, look up at submitted time (slightly off), clean up
+            Measure(interpolate ? "eye cache frame (interpolated)" : "eye cache frame",
+                    iterations,
+                    [&cache](const size_t i) {
+                        const XrTime time = 1000000000 + static_cast<XrTime>(i) * period;
+                        cache.AddSample(time, Poses(time), false);
+                        sink = cache.GetSample(time - period / 4).poses[0].position.x;
+                        cache.CleanUp(time - 3 * period);
+                    });
+        }
+
+        // lookups in a filled cache
+        Cache<EyePoses> cache("eyes", EyePoses{});
+        cache.SetTolerance(period);
+        for (XrTime frame = 0; frame < 32; frame++)
+        {
+            cache.AddSample(1000000000 + frame * period, Poses(frame), false);
+        }
+        Measure("eye cache lookup (32 entries)", iterations, [&cache](const size_t i) {
+            sink = cache.GetSample(1000000000 + static_cast<XrTime>(i % 32) * period + 1000).poses[0].position.x;
+        });
+    }
+
+    void BenchmarkSeqLock(const size_t iterations)
+    {
+        SeqLock<Dof> lock;
+        Dof dof{};
+        Measure("seqlock store", iterations, [&lock, &dof](const size_t i) {
+            dof.data[0] = static_cast<float>(i);
+            lock.Store(dof);
+        });
+        Measure("seqlock load", iterations, [&lock](const size_t) { sink = lock.Load().data[0]; });
+    }
+} // namespace
+
+int main(const int argc, const char* argv[])
+{
+    const size_t iterations = argc > 1 ? std::max(std::stoul(argv[1]), 1ul) : 10000000;
+#if defined(FILTER_AVX) && defined(__GNUC__)
+    if (!__builtin_cpu_supports("avx"))
+    {
+        printf("filter benchmark (avx): skipped, avx not supported\n");
+        return 77;
+    }
+#endif
+    printf("filter benchmark (%s), %zu iterations, time and heap allocations per iteration:\n", path, iterations);
+    BenchmarkFilters(iterations);
+    BenchmarkDispatch(iterations);
+    BenchmarkBiQuad(iterations);
+    BenchmarkStabilizers(iterations);
+    BenchmarkCache(iterations);
+    BenchmarkSeqLock(iterations);
+    MeasureResponses();
+    return 0;
+}
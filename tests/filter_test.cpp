@@ -0,0 +1,221 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#include "pch.h"
+
+#include "filter.h"
+
+#include "check.h"
+#include "config.h"
+
+using namespace filter;
+using namespace utility;
+
+namespace
+{
+    constexpr XrTime startTime{1000000000};
+    constexpr XrDuration period{11111111}; // 90 Hz
+    constexpr double frameTime{static_cast<double>(period) / 1e9};
+    constexpr float strength{0.5f};
+    constexpr float beta{0.5f};
+
+    void Configure(const bool adaptiveRate)
+    {
+        ConfigManager* config = GetConfig();
+        config->SetValue(Cfg::TransVerticalFactor, 1.f);
+        config->SetValue(Cfg::TransBeta, beta);
+        config->SetValue(Cfg::RotBeta, beta);
+        config->SetValue(Cfg::StabilizerStrength, strength);
+        config->SetValue(Cfg::StabilizerSway, 1.f);
+        config->SetValue(Cfg::StabilizerAdaptiveRate, adaptiveRate);
+    }
+
+    XrQuaternionf AroundY(const double angle)
+    {
+        return {0.f, static_cast<float>(sin(angle / 2.0)), 0.f, static_cast<float>(cos(angle / 2.0))};
+    }
+
+    // distance of the output behind a ramp of given speed (per second) after three seconds at 90 Hz
+    template <typename Filter>
+    double TranslationLag(const double speed)
+    {
+        Filter filter(strength);
+        filter.Reset({0.f, 0.f, 0.f});
+        double input{0.0};
+        XrVector3f location{};
+        for (int frame = 0; frame <= 270; frame++)
+        {
+            input = speed * frameTime * frame;
+            location = {static_cast<float>(input), 0.f, 0.f};
+            filter.Filter(location, startTime + frame * period);
+        }
+        return input - location.x;
+    }
+
+    template <typename Filter>
+    double RotationLag(const double speed)
+    {
+        Filter filter(strength);
+        filter.Reset(AroundY(0.0));
+        double input{0.0};
+        XrQuaternionf rotation{};
+        for (int frame = 0; frame <= 270; frame++)
+        {
+            input = speed * frameTime * frame;
+            rotation = AroundY(input);
+            filter.Filter(rotation, startTime + frame * period);
+        }
+        return input - 2.0 * atan2(rotation.y, rotation.w);
+    }
+
+    // steady state lag of a single exponential stage with given input weight behind a ramp
+    double ExpectedLag(const double speed, const double weight)
+    {
+        return speed * frameTime * (1.0 - weight) / weight;
+    }
+
+    // cutoff of the one euro filter rises with the speed of the input, not with the distance to its lagging output
+    double OneEuroWeight(const double speed)
+    {
+        const double cutoff = 25.0 * (1.0 - strength) + beta * speed;
+        return 1.0 / (1.0 + 1.0 / (2.0 * M_PI * cutoff) / frameTime);
+    }
+
+    void TestConstantInput()
+    {
+        Configure(false);
+        const XrVector3f constant{0.1f, -0.2f, 0.3f};
+        auto Translation = [&constant](auto&& filter) {
+            filter.Reset(constant);
+            XrVector3f location{};
+            for (int frame = 0; frame < 10; frame++)
+            {
+                location = constant;
+                filter.Filter(location, startTime + frame * period);
+            }
+            return std::abs(location.x - constant.x) + std::abs(location.y - constant.y) +
+                   std::abs(location.z - constant.z);
+        };
+        CHECK(Translation(SingleEmaFilter(strength)) < 1e-6f);
+        CHECK(Translation(DoubleEmaFilter(strength)) < 1e-6f);
+        CHECK(Translation(TripleEmaFilter(strength)) < 1e-6f);
+        CHECK(Translation(OneEuroTranslationFilter(strength)) < 1e-6f);
+
+        const XrQuaternionf orientation = AroundY(0.5);
+        auto Rotation = [&orientation](auto&& filter) {
+            filter.Reset(orientation);
+            XrQuaternionf rotation{};
+            for (int frame = 0; frame < 10; frame++)
+            {
+                rotation = orientation;
+                filter.Filter(rotation, startTime + frame * period);
+            }
+            return std::abs(rotation.y - orientation.y) + std::abs(rotation.w - orientation.w);
+        };
+        CHECK(Rotation(SingleSlerpFilter(strength)) < 1e-6f);
+        CHECK(Rotation(DoubleSlerpFilter(strength)) < 1e-6f);
+        CHECK(Rotation(TripleSlerpFilter(strength)) < 1e-6f);
+        CHECK(Rotation(OneEuroRotationFilter(strength)) < 1e-6f);
+    }
+
+    void TestRampLag()
+    {
+        Configure(false);
+        constexpr double speed{0.5};
+        CHECK_NEAR(TranslationLag<SingleEmaFilter>(speed), ExpectedLag(speed, 1.0 - strength), 1e-5);
+        // higher orders compensate the lag of a ramp
+        CHECK_NEAR(TranslationLag<DoubleEmaFilter>(speed), 0.0, 1e-5);
+        CHECK_NEAR(TranslationLag<TripleEmaFilter>(speed), 0.0, 1e-5);
+        CHECK_NEAR(RotationLag<SingleSlerpFilter>(speed), ExpectedLag(speed, 1.0 - strength), 1e-4);
+        // cascaded slerp stages add up their lag
+        CHECK_NEAR(RotationLag<DoubleSlerpFilter>(speed), 2.0 * ExpectedLag(speed, 1.0 - strength), 1e-4);
+    }
+
+    void TestOneEuroSpeed()
+    {
+        Configure(false);
+        for (const double speed : {0.2, 0.5, 2.0})
+        {
+            CHECK_NEAR(TranslationLag<OneEuroTranslationFilter>(speed),
+                       ExpectedLag(speed, OneEuroWeight(speed)),
+                       2e-5);
+            CHECK_NEAR(RotationLag<OneEuroRotationFilter>(speed), ExpectedLag(speed, OneEuroWeight(speed)), 1e-4);
+        }
+        // faster motion raises the cutoff: less lag than the filter would have at its minimum cutoff
+        CHECK(TranslationLag<OneEuroTranslationFilter>(2.0) < ExpectedLag(2.0, OneEuroWeight(0.0)) * 0.95);
+    }
+
+    // orientation is filtered as rotation vector relative to an anchor, constant input has to come out unchanged
+    // after small (series) and large (exact) offsets from the anchor
+    void TestRotationVector()
+    {
+        Configure(false);
+        GetConfig()->SetValue(Cfg::StabilizerYaw, 1.f);
+        GetConfig()->SetValue(Cfg::StabilizerRoll, 1.f);
+        GetConfig()->SetValue(Cfg::StabilizerPitch, 1.f);
+        BiQuadStabilizer stabilizer({yaw, roll, pitch}, 1000.0);
+        stabilizer.SetStartTime(startTime);
+        XrTime time = startTime;
+        for (const Dof& input : {Dof{0.f, 0.f, 0.f, 30.f, 5.f, -10.f},
+                                 Dof{0.f, 0.f, 0.f, 30.5f, 5.2f, -10.1f},
+                                 Dof{0.f, 0.f, 0.f, 75.f, -20.f, 15.f}})
+        {
+            for (int i = 0; i < 2000; i++)
+            {
+                stabilizer.Insert(input, time += 1000000);
+            }
+            Dof output{};
+            stabilizer.Read(output);
+            for (const DofValue value : {yaw, roll, pitch})
+            {
+                CHECK_NEAR(output.data[value], input.data[value], 1e-3f);
+            }
+        }
+    }
+
+    // output of a step at 2 ms intervals after 1 ms intervals, optionally with the time base jumping backwards
+    float StepAfterIntervalChange(const bool jump)
+    {
+        Configure(true);
+        BiQuadStabilizer stabilizer({sway}, 1000.0);
+        stabilizer.SetStartTime(startTime);
+        XrTime time = startTime;
+        Dof dof{};
+        for (int i = 0; i < 200; i++)
+        {
+            stabilizer.Insert(dof, time += 1000000);
+        }
+        if (jump)
+        {
+            time -= 10000000000;
+        }
+        for (int i = 0; i < 400; i++)
+        {
+            stabilizer.Insert(dof, time += 2000000);
+        }
+        dof.data[sway] = 1.f;
+        for (int i = 0; i < 10; i++)
+        {
+            stabilizer.Insert(dof, time += 2000000);
+        }
+        stabilizer.Read(dof);
+        return dof.data[sway];
+    }
+
+    // adaption continues after the time base has jumped backwards
+    void TestAdaptiveRateAfterTimeJump()
+    {
+        const float reference = StepAfterIntervalChange(false);
+        CHECK(reference > 0.1f && reference < 0.9f);
+        CHECK_NEAR(StepAfterIntervalChange(true), reference, 1e-4f);
+    }
+} // namespace
+
+int main()
+{
+    TestConstantInput();
+    TestRampLag();
+    TestOneEuroSpeed();
+    TestRotationVector();
+    TestAdaptiveRateAfterTimeJump();
+    return check::Result("filter");
+}
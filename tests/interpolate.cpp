@@ -0,0 +1,27 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#include "pch.h"
+
+namespace utility
+{
+    // pose interpolation of the layer relies on DirectXMath, the cache only needs any implementation:
+    // linear for position, orientation of the nearer pose
+    XrPosef Interpolate(const XrPosef& earlier, const XrPosef& later, const float alpha)
+    {
+        const XrVector3f& a = earlier.position;
+        const XrVector3f& b = later.position;
+        return {alpha < 0.5f ? earlier.orientation : later.orientation,
+                {a.x + (b.x - a.x) * alpha, a.y + (b.y - a.y) * alpha, a.z + (b.z - a.z) * alpha}};
+    }
+
+    EyePoses Interpolate(const EyePoses& earlier, const EyePoses& later, const float alpha)
+    {
+        EyePoses poses;
+        poses.count = std::min(earlier.count, later.count);
+        for (uint32_t i = 0; i < poses.count; i++)
+        {
+            poses.poses[i] = Interpolate(earlier.poses[i], later.poses[i], alpha);
+        }
+        return poses;
+    }
+} // namespace utility
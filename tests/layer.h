@@ -0,0 +1,11 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#pragma once
+
+// Stand-in for layer.h: the layer itself isn't built, its translation units only use the data directory.
+
+namespace openxr_api_layer
+{
+    // tests write into the working directory
+    inline std::filesystem::path localAppData{"."};
+} // namespace openxr_api_layer
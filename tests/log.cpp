@@ -0,0 +1,52 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#include "pch.h"
+
+#include <log.h>
+
+#include "check.h"
+
+namespace openxr_api_layer::log
+{
+    // log output of the code under test goes to the console, debug output only if verbose
+    namespace
+    {
+        void InternalLog(const char* prefix, const char* fmt, va_list va)
+        {
+            if (check::quiet)
+            {
+                return;
+            }
+            fputs(prefix, stderr);
+            vfprintf(stderr, fmt, va);
+            fputc('\n', stderr);
+        }
+    } // namespace
+
+    void Log(const char* fmt, ...)
+    {
+        va_list va;
+        va_start(va, fmt);
+        InternalLog("", fmt, va);
+        va_end(va);
+    }
+
+    void ErrorLog(const char* fmt, ...)
+    {
+        va_list va;
+        va_start(va, fmt);
+        InternalLog("error - ", fmt, va);
+        va_end(va);
+    }
+
+    void DebugLog(const char* fmt, ...)
+    {
+        if (logVerbose)
+        {
+            va_list va;
+            va_start(va, fmt);
+            InternalLog("", fmt, va);
+            va_end(va);
+        }
+    }
+} // namespace openxr_api_layer::log
@@ -0,0 +1,79 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#include "pch.h"
+
+#include "shm.h"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+using namespace utility;
+
+// Writes a 6dof virtual tracker mmf in the versioned format (see developer's manual), e.g. to test the layer or a
+// motion software integration without a motion rig. All dofs follow sine waves of 0.5 Hz (50 mm and 5 degrees).
+// Usage: mmf_publisher [name] [update rate in Hz] [duration in seconds, 0 = until terminated]
+
+namespace
+{
+    // payload of a 6dof virtual tracker: translation in mm, rotation in degrees
+    struct SixDof
+    {
+        double sway, surge, heave, yaw, roll, pitch;
+    };
+
+    SixDof Motion(const double seconds)
+    {
+        constexpr double frequency{0.5}, translation{50.0}, rotation{5.0};
+        auto Wave = [seconds](const double amplitude, const double phase) {
+            return amplitude * sin(2.0 * 3.14159265358979323846 * (frequency * seconds + phase));
+        };
+        return {Wave(translation, 0.0),
+                Wave(translation, 1.0 / 6.0),
+                Wave(translation, 2.0 / 6.0),
+                Wave(rotation, 3.0 / 6.0),
+                Wave(rotation, 4.0 / 6.0),
+                Wave(rotation, 5.0 / 6.0)};
+    }
+} // namespace
+
+int main(const int argc, const char* argv[])
+{
+    const std::string name = argc > 1 ? argv[1] : "Local\\motionRigPose";
+    const double rate = argc > 2 ? std::stod(argv[2]) : 1000.0;
+    const double runtime = argc > 3 ? std::stod(argv[3]) : 0.0;
+    if (rate <= 0.0 || runtime < 0.0)
+    {
+        fprintf(stderr, "usage: mmf_publisher [name] [update rate in Hz] [duration in seconds, 0 = until terminated]\n");
+        return 1;
+    }
+
+    MmfPublisher<SixDof> publisher;
+    if (!publisher.Open(name))
+    {
+        fprintf(stderr, "unable to open %s: %s\n", name.c_str(), shm::SharedMemory::LastError().c_str());
+        return 1;
+    }
+    printf("publishing to %s at %.0f Hz\n", name.c_str(), rate);
+
+    using namespace std::chrono;
+    const auto interval = duration_cast<steady_clock::duration>(duration<double>(1.0 / rate));
+    const auto start = steady_clock::now();
+    auto next = start;
+    for (double elapsed = 0.0; 0.0 == runtime || elapsed < runtime;)
+    {
+        publisher.Publish(Motion(elapsed));
+        next += interval;
+        std::this_thread::sleep_until(next);
+        elapsed = duration<double>(steady_clock::now() - start).count();
+    }
+    printf("published %llu updates\n", static_cast<unsigned long long>(publisher.GetUpdates()));
+
+    publisher.Close();
+#ifndef _WIN32
+    // windows removes the mapping with its last handle
+    const std::string posixName = std::string("/").append(name.substr(name.find('\\') + 1));
+    shm_unlink(posixName.c_str());
+#endif
+    return 0;
+}
@@ -0,0 +1,95 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#pragma once
+
+// Stand-in for the layer's precompiled header: the standard library and just enough OpenXR and tracelogging
+// declarations to build the platform independent parts of the layer without the Windows SDK and OpenXR headers.
+
+// Standard library.
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdarg>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+#include <vector>
+#include <set>
+#include <map>
+#include <deque>
+#include <cmath>
+#include <complex>
+#include <variant>
+#include <span>
+#include <bit>
+#include <chrono>
+#include <optional>
+#include <cstdint>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include "virtual_keys.h"
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#define M_PI_4 0.785398163397448309616
+#endif
+
+// OpenXR types used by the layer utilities.
+typedef int64_t XrTime;
+typedef int64_t XrDuration;
+
+struct XrVector3f
+{
+    float x, y, z;
+};
+
+struct XrQuaternionf
+{
+    float x, y, z, w;
+};
+
+struct XrPosef
+{
+    XrQuaternionf orientation;
+    XrVector3f position;
+};
+
+// Tracelogging compiles to nothing.
+#define TRACELOGGING_DECLARE_PROVIDER(provider) inline const int provider{0}
+#define TraceLoggingProviderEnabled(...) false
+#define TraceLoggingValue(...) 0
+#define TraceLoggingPointer(...) 0
+#define TraceLoggingWrite(...) ((void)0)
+#define TraceLoggingWriteStart(...) ((void)0)
+#define TraceLoggingWriteStop(...) ((void)0)
+#define TraceLoggingWriteTagged(...) ((void)0)
+
+// user-provided destructor like the real activity, so unused activities don't warn
+template <const int& Provider>
+class TraceLoggingActivity
+{
+  public:
+    ~TraceLoggingActivity() {}
+};
+
+// XrMath
+#include <XrMath.h>
+
+// utility
+#include <utility.h>
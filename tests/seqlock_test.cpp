@@ -0,0 +1,130 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#include "pch.h"
+
+#include "check.h"
+
+using namespace utility;
+
+namespace
+{
+    // size of a dof set plus a counter, spans several words of the lock
+    struct Value
+    {
+        uint64_t counter;
+        double data[7];
+    };
+
+    Value Make(const uint64_t counter)
+    {
+        Value value{counter, {}};
+        for (size_t i = 0; i < std::size(value.data); i++)
+        {
+            value.data[i] = static_cast<double>(counter) + static_cast<double>(i) * 0.5;
+        }
+        return value;
+    }
+
+    bool IsConsistent(const Value& value)
+    {
+        for (size_t i = 0; i < std::size(value.data); i++)
+        {
+            if (value.data[i] != static_cast<double>(value.counter) + static_cast<double>(i) * 0.5)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    struct ReaderResult
+    {
+        uint64_t loads{0};
+        uint64_t torn{0};
+        uint64_t backwards{0};
+    };
+
+    // readers load while the writer stores, returns loads per reader
+    std::vector<ReaderResult> Run(const size_t readers, const bool write, const std::chrono::milliseconds duration)
+    {
+        SeqLock<Value> lock;
+        lock.Store(Make(0));
+        std::atomic_bool stop{false};
+
+        std::vector<ReaderResult> results(readers);
+        std::vector<std::thread> threads;
+        for (size_t reader = 0; reader < readers; reader++)
+        {
+            threads.emplace_back([&lock, &stop, &result = results[reader]] {
+                uint64_t last{0};
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    const Value value = lock.Load();
+                    result.loads++;
+                    if (!IsConsistent(value))
+                    {
+                        result.torn++;
+                    }
+                    if (value.counter < last)
+                    {
+                        result.backwards++;
+                    }
+                    last = value.counter;
+                }
+            });
+        }
+        std::thread writer([&lock, &stop, write] {
+            for (uint64_t counter = 1; write && !stop.load(std::memory_order_relaxed); counter++)
+            {
+                lock.Store(Make(counter));
+            }
+        });
+
+        std::this_thread::sleep_for(duration);
+        stop.store(true);
+        writer.join();
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        return results;
+    }
+
+    // one writer and several readers: no torn or outdated values
+    void TestConsistency()
+    {
+        for (const ReaderResult& result : Run(3, true, std::chrono::milliseconds(300)))
+        {
+            CHECK(result.loads > 0);
+            CHECK(0 == result.torn);
+            CHECK(0 == result.backwards);
+        }
+    }
+
+    // loads per second of each reader with and without concurrent writes, informational only
+    void MeasureContention()
+    {
+        const size_t readers = std::clamp<size_t>(std::thread::hardware_concurrency(), 2, 4) - 1;
+        for (const bool write : {false, true})
+        {
+            constexpr std::chrono::milliseconds duration{200};
+            const std::vector<ReaderResult> results = Run(readers, write, duration);
+            uint64_t loads{0};
+            for (const ReaderResult& result : results)
+            {
+                loads += result.loads;
+            }
+            printf("seqlock: %s writer, %zu reader(s): %.1f M loads/s each\n",
+                   write ? "busy" : "idle",
+                   readers,
+                   static_cast<double>(loads) / static_cast<double>(readers) / (duration.count() * 1e3));
+        }
+    }
+} // namespace
+
+int main()
+{
+    TestConsistency();
+    MeasureContention();
+    return check::Result("seqlock");
+}
@@ -0,0 +1,140 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#include "pch.h"
+
+#include "check.h"
+#include "shm.h"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace utility;
+
+namespace
+{
+    // payload of a 6dof virtual tracker
+    struct SixDof
+    {
+        double sway, surge, heave, yaw, roll, pitch;
+    };
+
+    struct VersionedMmf
+    {
+        MmfHeader header;
+        SixDof payload;
+    };
+
+    std::string TestName()
+    {
+#ifdef _WIN32
+        return "Local\\oxrmcShmTest" + std::to_string(GetCurrentProcessId());
+#else
+        return "Local\\oxrmcShmTest" + std::to_string(getpid());
+#endif
+    }
+
+    // reader side of the versioned format, see Mmf::Access
+    bool Read(const void* view, SixDof& payload, uint64_t& sequence)
+    {
+        auto* mmf = const_cast<VersionedMmf*>(static_cast<const VersionedMmf*>(view));
+        std::atomic_ref counter(mmf->header.sequence);
+        for (int attempt = 0; attempt < 1000; attempt++)
+        {
+            const uint64_t before = counter.load(std::memory_order_acquire);
+            if (!(before & 1))
+            {
+                payload = mmf->payload;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (counter.load(std::memory_order_relaxed) == before)
+                {
+                    sequence = before;
+                    return true;
+                }
+            }
+            std::this_thread::yield();
+        }
+        return false;
+    }
+
+    void TestMissing()
+    {
+        shm::SharedMemory memory;
+        CHECK(!memory.OpenHandle(TestName() + "Missing", false, 0));
+        CHECK(!memory.IsOpen());
+        CHECK(!shm::SharedMemory::LastError().empty());
+    }
+
+    void TestPublish()
+    {
+        const std::string name = TestName();
+        MmfPublisher<SixDof> publisher;
+        CHECK(publisher.Open(name));
+
+        shm::SharedMemory reader;
+        CHECK(reader.OpenHandle(name, false, 0));
+        CHECK(reader.Map());
+        const auto* header = static_cast<const MmfHeader*>(reader.GetView());
+        CHECK(MmfHeader::m_Magic == header->magic);
+        CHECK(MmfHeader::m_Version == header->version);
+        CHECK(sizeof(SixDof) == header->size);
+
+        // concurrent updates must never be observed partially
+        constexpr int updates{100000};
+        std::thread producer([&publisher] {
+            for (int i = 1; i <= updates; i++)
+            {
+                const double value = i;
+                publisher.Publish({value, value, value, value, value, value});
+            }
+        });
+        uint64_t previous{0};
+        int torn{0}, reads{0};
+        while (previous < 2 * updates)
+        {
+            SixDof payload{};
+            uint64_t sequence{0};
+            if (!Read(reader.GetView(), payload, sequence))
+            {
+                continue;
+            }
+            reads++;
+            torn += payload.sway != payload.pitch || payload.surge != payload.roll || payload.heave != payload.yaw;
+            CHECK(sequence >= previous);
+            CHECK(payload.sway == static_cast<double>(sequence / 2));
+            previous = sequence;
+        }
+        producer.join();
+        CHECK(0 == torn);
+        CHECK(reads > 0);
+
+        const int64_t age = shm::Counter() - header->timestamp;
+        CHECK(age >= 0 && age < shm::CounterFrequency());
+
+        CHECK(updates == publisher.GetUpdates());
+
+        reader.Close();
+        publisher.Close();
+        CHECK(!reader.IsOpen() && !reader.GetView());
+#ifndef _WIN32
+        shm_unlink(("/" + name.substr(name.find('\\') + 1)).c_str());
+#endif
+    }
+
+    void TestCounter()
+    {
+        const int64_t first = shm::Counter();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        const double elapsed = static_cast<double>(shm::Counter() - first) / shm::CounterFrequency();
+        CHECK(elapsed >= 0.009 && elapsed < 1.0);
+    }
+} // namespace
+
+int main()
+{
+    TestMissing();
+    TestPublish();
+    TestCounter();
+    return check::Result("shm");
+}
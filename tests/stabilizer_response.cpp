@@ -0,0 +1,90 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#include "pch.h"
+
+#include "filter.h"
+
+#include "config.h"
+
+using namespace filter;
+using namespace utility;
+
+// Frequency response of the input stabilizer as json, computed offline with the filter design of the layer.
+// Usage: stabilizer_response [strength] [biquad|ema] [sampling rate in Hz]
+
+namespace
+{
+    constexpr const char* names[]{"sway", "surge", "heave", "yaw", "roll", "pitch"};
+
+    // json has no infinity, a blocked dof has no magnitude
+    std::string ToJson(const float value)
+    {
+        if (!std::isfinite(value))
+        {
+            return "null";
+        }
+        std::ostringstream stream;
+        stream << value;
+        return stream.str();
+    }
+} // namespace
+
+int main(const int argc, const char* argv[])
+{
+    const float strength = argc > 1 ? std::stof(argv[1]) : 0.5f;
+    const std::string type = argc > 2 ? argv[2] : "biquad";
+    const double samplingRate = argc > 3 ? std::stod(argv[3]) : 1000.0;
+    if (("biquad" != type && "ema" != type) || samplingRate <= 0.0)
+    {
+        fprintf(stderr, "usage: stabilizer_response [strength] [biquad|ema] [sampling rate in Hz]\n");
+        return 1;
+    }
+
+    ConfigManager* config = GetConfig();
+    config->SetValue(Cfg::StabilizerStrength, strength);
+    for (const Cfg key : {Cfg::StabilizerSway,
+                          Cfg::StabilizerSurge,
+                          Cfg::StabilizerHeave,
+                          Cfg::StabilizerYaw,
+                          Cfg::StabilizerRoll,
+                          Cfg::StabilizerPitch})
+    {
+        config->SetValue(key, 1.f);
+    }
+    const std::vector<DofValue> relevant{sway, surge, heave, yaw, roll, pitch};
+    std::unique_ptr<LowPassStabilizer> stabilizer;
+    if ("biquad" == type)
+    {
+        stabilizer = std::make_unique<BiQuadStabilizer>(relevant, samplingRate);
+    }
+    else
+    {
+        stabilizer = std::make_unique<EmaStabilizer>(relevant, samplingRate);
+    }
+
+    // logarithmic sweep from 0.1 Hz to 100 Hz, same as the csv file written by the layer
+    std::vector<float> frequencies;
+    for (int i = 0; i <= 60; i++)
+    {
+        frequencies.push_back(0.1f * powf(10.f, static_cast<float>(i) / 20.f));
+    }
+
+    std::cout << "{\n  \"type\": \"" << type << "\",\n  \"strength\": " << strength
+              << ",\n  \"samplingRate\": " << samplingRate << ",\n  \"dofs\": [";
+    for (const DofValue value : relevant)
+    {
+        std::cout << (sway == value ? "" : ",") << "\n    {\n      \"dof\": \"" << names[value]
+                  << "\",\n      \"cutoff\": " << ToJson(stabilizer->GetCutoff(value)) << ",\n      \"response\": [";
+        const std::vector<FrequencyResponse> response = stabilizer->GetFrequencyResponse(value, frequencies);
+        for (size_t i = 0; i < response.size(); i++)
+        {
+            const auto& [frequency, magnitude, phase, groupDelay] = response[i];
+            std::cout << (i ? "," : "") << "\n        {\"frequency\": " << ToJson(frequency)
+                      << ", \"magnitude\": " << ToJson(magnitude) << ", \"phase\": " << ToJson(phase)
+                      << ", \"groupDelay\": " << ToJson(groupDelay) << "}";
+        }
+        std::cout << "\n      ]\n    }";
+    }
+    std::cout << "\n  ]\n}\n";
+    return 0;
+}
@@ -0,0 +1,54 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#pragma once
+
+// Stand-in for util.h of the layer framework, which depends on std::format and the OpenXR headers.
+
+namespace xr
+{
+    namespace detail
+    {
+        inline std::string Format(const char* format, ...)
+        {
+            char buffer[256];
+            va_list va;
+            va_start(va, format);
+            vsnprintf(buffer, sizeof(buffer), format, va);
+            va_end(va);
+            return buffer;
+        }
+    } // namespace detail
+
+    inline std::string ToString(const XrPosef& pose)
+    {
+        return detail::Format("p: (%.3f, %.3f, %.3f), o:(%.3f, %.3f, %.3f, %.3f)",
+                              pose.position.x,
+                              pose.position.y,
+                              pose.position.z,
+                              pose.orientation.x,
+                              pose.orientation.y,
+                              pose.orientation.z,
+                              pose.orientation.w);
+    }
+
+    inline std::string ToString(const utility::Dof& dof)
+    {
+        return detail::Format("sway: %f, surge: %f, heave: %f, yaw: %f, roll: %f, pitch: %f",
+                              dof.data[utility::sway],
+                              dof.data[utility::surge],
+                              dof.data[utility::heave],
+                              dof.data[utility::yaw],
+                              dof.data[utility::roll],
+                              dof.data[utility::pitch]);
+    }
+
+    inline std::string ToString(const XrVector3f& vec)
+    {
+        return detail::Format("(%.3f, %.3f, %.3f)", vec.x, vec.y, vec.z);
+    }
+
+    inline std::string ToString(const XrQuaternionf& quat)
+    {
+        return detail::Format("(%.3f, %.3f, %.3f, %.3f)", quat.x, quat.y, quat.z, quat.w);
+    }
+} // namespace xr